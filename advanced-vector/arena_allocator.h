@@ -0,0 +1,185 @@
+#pragma once
+#include "vector.h"
+
+#include <cstdint>
+
+// Монотонный арена-аллокатор для данных с общим временем жизни, например на время обработки
+// запроса. Память выдаётся сдвигом указателя внутри крупных блоков (слэбов), освобождение
+// отдельных выделений ничего не делает, а Reset() разом возвращает всю память арене, сохраняя
+// слэбы для следующего запроса. Последнее выделение можно расширить на месте, если за ним
+// в слэбе есть место. Арена не потокобезопасна: у каждого потока своя арена ThreadLocal()
+class ArenaResource {
+public:
+    static constexpr size_t INITIAL_SLAB_SIZE = size_t{ 64 } << 10;
+    static constexpr size_t MAX_SLAB_SIZE = size_t{ 16 } << 20;
+
+    explicit ArenaResource(size_t initial_slab_size = INITIAL_SLAB_SIZE) noexcept
+        : next_slab_size_(std::max<size_t>(initial_slab_size, 1)) {
+    }
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    ~ArenaResource() {
+        Release();
+    }
+
+    // Арена текущего потока, которую по умолчанию используют ArenaAllocator и ArenaVector
+    static ArenaResource& ThreadLocal() {
+        static thread_local ArenaResource arena;
+        return arena;
+    }
+
+    void* Allocate(size_t bytes, size_t alignment) {
+        char* p = AlignUp(top_, alignment);
+        if (top_ == nullptr || p > end_ || bytes > static_cast<size_t>(end_ - p)) {
+            NextSlab(bytes + alignment);
+            p = AlignUp(top_, alignment);
+        }
+        top_ = p + bytes;
+        used_ += bytes;
+        return p;
+    }
+
+    // Расширяет выделение p до new_bytes, если оно последнее в текущем слэбе и место есть
+    bool TryExpand(void* p, size_t old_bytes, size_t new_bytes) noexcept {
+        char* block = static_cast<char*>(p);
+        if (block < slab_begin_ || block + old_bytes != top_ || new_bytes < old_bytes
+            || new_bytes - old_bytes > static_cast<size_t>(end_ - top_)) {
+            return false;
+        }
+        top_ += new_bytes - old_bytes;
+        used_ += new_bytes - old_bytes;
+        return true;
+    }
+
+    // Делает всю выданную память снова свободной. Объекты, размещённые в арене,
+    // к этому моменту должны быть разрушены
+    void Reset() noexcept {
+        current_ = 0;
+        used_ = 0;
+        if (slabs_.Size() != 0) {
+            SetSlab(0);
+        }
+    }
+
+    // Возвращает слэбы системе
+    void Release() noexcept {
+        for (const Slab& slab : slabs_) {
+            ::operator delete(slab.data, slab.size);
+        }
+        slabs_.ClearAndRelease();
+        current_ = 0;
+        used_ = 0;
+        slab_begin_ = top_ = end_ = nullptr;
+    }
+
+    // Байты, выданные с последнего Reset
+    size_t BytesUsed() const noexcept {
+        return used_;
+    }
+
+    size_t SlabCount() const noexcept {
+        return slabs_.Size();
+    }
+
+private:
+    struct Slab {
+        char* data;
+        size_t size;
+    };
+
+    static char* AlignUp(char* p, size_t alignment) noexcept {
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((addr + alignment - 1) & ~uintptr_t{ alignment - 1 });
+    }
+
+    // Переходит к следующему сохранённому слэбу не меньше min_size или выделяет новый
+    void NextSlab(size_t min_size) {
+        for (size_t i = top_ == nullptr ? current_ : current_ + 1; i < slabs_.Size(); ++i) {
+            if (slabs_[i].size >= min_size) {
+                current_ = i;
+                SetSlab(i);
+                return;
+            }
+        }
+        const size_t size = std::max(next_slab_size_, min_size);
+        // Место в каталоге резервируется заранее, чтобы PushBack не мог бросить после выделения слэба
+        if (slabs_.Size() == slabs_.Capacity()) {
+            slabs_.Reserve(std::max<size_t>(4, slabs_.Capacity() * 2));
+        }
+        slabs_.PushBack(Slab{ static_cast<char*>(::operator new(size)), size });
+        next_slab_size_ = std::min(next_slab_size_ * 2, MAX_SLAB_SIZE);
+        current_ = slabs_.Size() - 1;
+        SetSlab(current_);
+    }
+
+    void SetSlab(size_t index) noexcept {
+        slab_begin_ = top_ = slabs_[index].data;
+        end_ = slabs_[index].data + slabs_[index].size;
+    }
+
+    Vector<Slab> slabs_;
+    size_t current_ = 0;
+    size_t next_slab_size_;
+    size_t used_ = 0;
+    char* slab_begin_ = nullptr;
+    char* top_ = nullptr;
+    char* end_ = nullptr;
+};
+
+// Аллокатор поверх ArenaResource. deallocate ничего не делает, память возвращается ArenaResource::Reset.
+// try_expand позволяет Vector расти на месте, пока его буфер - последнее выделение арены
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept
+        : arena_(&ArenaResource::ThreadLocal()) {
+    }
+
+    explicit ArenaAllocator(ArenaResource& arena) noexcept
+        : arena_(&arena) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_(&other.Arena()) {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* /*p*/, size_t /*n*/) noexcept {
+    }
+
+    bool try_expand(T* p, size_t old_n, size_t new_n) noexcept {
+        return new_n <= std::numeric_limits<size_t>::max() / sizeof(T)
+               && arena_->TryExpand(p, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
+    ArenaResource& Arena() const noexcept {
+        return *arena_;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == &other.Arena();
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ != &other.Arena();
+    }
+
+private:
+    ArenaResource* arena_;
+};
+
+// Вектор в арене текущего потока (или переданной в конструктор через ArenaAllocator)
+template <typename T, typename Growth = DoublingGrowth>
+using ArenaVector = Vector<T, ArenaAllocator<T>, Growth>;
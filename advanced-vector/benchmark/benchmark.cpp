@@ -0,0 +1,512 @@
+#include "vector.h"
+#include "vector_algorithms.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Набор микробенчмарков, сравнивающих Vector и std::vector.
+// Запуск: AdvancedVectorBenchmark [--format=csv|json] [--filter=<подстрока>] [--max-size=N]
+//         [--max-bytes=N] [--min-time-ms=N] [--label=<метка, например хеш коммита>]
+// Результаты выводятся в stdout в формате CSV (по умолчанию) или JSON
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Не даёт компилятору выбросить вычисление value как неиспользуемое
+    template <typename T>
+    void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+        asm volatile("" : : "r"(&value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+#endif
+    }
+
+    struct Pod64 {
+        uint64_t data[8];
+    };
+
+    // Аналог Obj из тестов: копирование может выбросить исключение,
+    // а перемещение не объявлено noexcept, поэтому при реаллокации элементы копируются
+    struct ThrowingObj {
+        ThrowingObj() = default;
+        explicit ThrowingObj(int id)
+            : id(id)
+            , name("object #" + std::to_string(id)) {
+        }
+        ThrowingObj(const ThrowingObj& other)
+            : id(other.id)
+            , name(other.name) {
+            if (other.throw_on_copy) {
+                throw std::runtime_error("Oops");
+            }
+        }
+        ThrowingObj(ThrowingObj&& other)
+            : id(other.id)
+            , name(std::move(other.name)) {
+        }
+        ThrowingObj& operator=(const ThrowingObj& other) = default;
+        ThrowingObj& operator=(ThrowingObj&& other) = default;
+
+        int id = 0;
+        std::string name;
+        bool throw_on_copy = false;
+    };
+
+    // Дескриптор с нетривиальным перемещением, помеченный как тривиально перемещаемый
+    struct Handle {
+        Handle() = default;
+        explicit Handle(int fd)
+            : fd(fd) {
+        }
+        Handle(Handle&& other) noexcept
+            : fd(std::exchange(other.fd, -1)) {
+        }
+        Handle(const Handle& other) = default;
+        Handle& operator=(const Handle& other) = default;
+        Handle& operator=(Handle&& other) noexcept {
+            fd = std::exchange(other.fd, -1);
+            return *this;
+        }
+        ~Handle() {
+            fd = -1;
+        }
+        int fd = -1;
+        char payload[28] = {};
+    };
+
+}  // namespace
+
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type {
+};
+
+namespace {
+
+    // Способ получить значения каждого типа и оценка занимаемой элементом памяти
+    template <typename T>
+    struct Factory;
+
+    template <>
+    struct Factory<int> {
+        static constexpr std::string_view NAME = "int";
+        static constexpr size_t BYTES = sizeof(int);
+        static int Make(size_t i) {
+            return static_cast<int>(i);
+        }
+    };
+
+    template <>
+    struct Factory<Pod64> {
+        static constexpr std::string_view NAME = "pod64";
+        static constexpr size_t BYTES = sizeof(Pod64);
+        static Pod64 Make(size_t i) {
+            Pod64 pod{};
+            pod.data[0] = i;
+            return pod;
+        }
+    };
+
+    template <>
+    struct Factory<std::string> {
+        static constexpr std::string_view NAME = "string";
+        // Строки длиннее буфера SSO занимают ещё и динамическую память
+        static constexpr size_t BYTES = sizeof(std::string) + 48;
+        static std::string Make(size_t i) {
+            return std::string(32, static_cast<char>('a' + i % 26));
+        }
+    };
+
+    template <>
+    struct Factory<ThrowingObj> {
+        static constexpr std::string_view NAME = "throwing_obj";
+        static constexpr size_t BYTES = sizeof(ThrowingObj) + 32;
+        static ThrowingObj Make(size_t i) {
+            return ThrowingObj(static_cast<int>(i));
+        }
+    };
+
+    template <>
+    struct Factory<Handle> {
+        static constexpr std::string_view NAME = "relocatable_handle";
+        static constexpr size_t BYTES = sizeof(Handle);
+        static Handle Make(size_t i) {
+            return Handle(static_cast<int>(i));
+        }
+    };
+
+    // Единый интерфейс к std::vector и Vector
+
+    template <typename T, typename U>
+    void PushBack(std::vector<T>& v, U&& value) {
+        v.push_back(std::forward<U>(value));
+    }
+    template <typename T, typename U>
+    void PushBack(Vector<T>& v, U&& value) {
+        v.PushBack(std::forward<U>(value));
+    }
+
+    template <typename T, typename... Args>
+    void EmplaceBack(std::vector<T>& v, Args&&... args) {
+        v.emplace_back(std::forward<Args>(args)...);
+    }
+    template <typename T, typename... Args>
+    void EmplaceBack(Vector<T>& v, Args&&... args) {
+        v.EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename U>
+    void InsertAt(std::vector<T>& v, size_t index, U&& value) {
+        v.insert(v.begin() + index, std::forward<U>(value));
+    }
+    template <typename T, typename U>
+    void InsertAt(Vector<T>& v, size_t index, U&& value) {
+        v.Insert(v.cbegin() + index, std::forward<U>(value));
+    }
+
+    template <typename T>
+    void EraseAt(std::vector<T>& v, size_t index) {
+        v.erase(v.begin() + index);
+    }
+    template <typename T>
+    void EraseAt(Vector<T>& v, size_t index) {
+        v.Erase(v.cbegin() + index);
+    }
+
+    template <typename T>
+    void Reserve(std::vector<T>& v, size_t capacity) {
+        v.reserve(capacity);
+    }
+    template <typename T>
+    void Reserve(Vector<T>& v, size_t capacity) {
+        v.Reserve(capacity);
+    }
+
+    template <typename T>
+    size_t Size(const std::vector<T>& v) {
+        return v.size();
+    }
+    template <typename T>
+    size_t Size(const Vector<T>& v) {
+        return v.Size();
+    }
+
+    template <typename T>
+    const T* FindValue(const std::vector<T>& v, const T& value) {
+        return v.data() + (std::find(v.begin(), v.end(), value) - v.begin());
+    }
+    template <typename T>
+    const T* FindValue(const Vector<T>& v, const T& value) {
+        return Find(v, value);
+    }
+
+    template <typename T>
+    size_t CountValue(const std::vector<T>& v, const T& value) {
+        return std::count(v.begin(), v.end(), value);
+    }
+    template <typename T>
+    size_t CountValue(const Vector<T>& v, const T& value) {
+        return Count(v, value);
+    }
+
+    template <typename C, typename T>
+    C MakeContainer(size_t size, size_t extra_capacity = 0) {
+        C c;
+        Reserve(c, size + extra_capacity);
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(c, Factory<T>::Make(i));
+        }
+        return c;
+    }
+
+    uint64_t ElapsedNs(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    // Количество вставок/удалений в середине за одну итерацию
+    const size_t MID_OPS = 16;
+
+    // Каждый бенчмарк готовит данные вне замера и возвращает время замеренной части в наносекундах
+
+    template <typename C, typename T>
+    uint64_t BenchPushBack(size_t size) {
+        C c;
+        const auto start = Clock::now();
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(c, Factory<T>::Make(i));
+        }
+        const uint64_t ns = ElapsedNs(start);
+        DoNotOptimize(c);
+        return ns;
+    }
+
+    template <typename C, typename T>
+    uint64_t BenchEmplaceBack(size_t size) {
+        C c;
+        const auto start = Clock::now();
+        for (size_t i = 0; i < size; ++i) {
+            EmplaceBack(c, Factory<T>::Make(i));
+        }
+        const uint64_t ns = ElapsedNs(start);
+        DoNotOptimize(c);
+        return ns;
+    }
+
+    template <typename C, typename T>
+    uint64_t BenchInsertMid(size_t size) {
+        C c = MakeContainer<C, T>(size, MID_OPS);
+        const T value = Factory<T>::Make(size);
+        const auto start = Clock::now();
+        for (size_t i = 0; i < MID_OPS; ++i) {
+            InsertAt(c, Size(c) / 2, value);
+        }
+        const uint64_t ns = ElapsedNs(start);
+        DoNotOptimize(c);
+        return ns;
+    }
+
+    template <typename C, typename T>
+    uint64_t BenchEraseMid(size_t size) {
+        C c = MakeContainer<C, T>(size + MID_OPS);
+        const auto start = Clock::now();
+        for (size_t i = 0; i < MID_OPS; ++i) {
+            EraseAt(c, Size(c) / 2);
+        }
+        const uint64_t ns = ElapsedNs(start);
+        DoNotOptimize(c);
+        return ns;
+    }
+
+    template <typename C, typename T>
+    uint64_t BenchReserve(size_t size) {
+        C c = MakeContainer<C, T>(size);
+        const auto start = Clock::now();
+        Reserve(c, size * 2);
+        const uint64_t ns = ElapsedNs(start);
+        DoNotOptimize(c);
+        return ns;
+    }
+
+    template <typename C, typename T>
+    uint64_t BenchCopyAssign(size_t size) {
+        const C src = MakeContainer<C, T>(size);
+        C dst = MakeContainer<C, T>(size / 2);
+        const auto start = Clock::now();
+        dst = src;
+        const uint64_t ns = ElapsedNs(start);
+        DoNotOptimize(dst);
+        return ns;
+    }
+
+    template <typename C, typename T>
+    uint64_t BenchMove(size_t size) {
+        C src = MakeContainer<C, T>(size);
+        const auto start = Clock::now();
+        C dst(std::move(src));
+        const uint64_t ns = ElapsedNs(start);
+        DoNotOptimize(dst);
+        return ns;
+    }
+
+    // Поиск отсутствующего значения просматривает весь контейнер
+    template <typename C, typename T>
+    uint64_t BenchFind(size_t size) {
+        const C c = MakeContainer<C, T>(size);
+        const T value = Factory<T>::Make(size);
+        const auto start = Clock::now();
+        const T* pos = FindValue(c, value);
+        const uint64_t ns = ElapsedNs(start);
+        DoNotOptimize(pos);
+        return ns;
+    }
+
+    template <typename C, typename T>
+    uint64_t BenchCount(size_t size) {
+        const C c = MakeContainer<C, T>(size);
+        const T value = Factory<T>::Make(size / 2);
+        const auto start = Clock::now();
+        const size_t count = CountValue(c, value);
+        const uint64_t ns = ElapsedNs(start);
+        DoNotOptimize(count);
+        return ns;
+    }
+
+    struct Options {
+        bool json = false;
+        std::string filter;
+        std::string label;
+        size_t max_size = 100'000'000;
+        size_t max_bytes = size_t{ 1 } << 30;
+        uint64_t min_time_ns = 100'000'000;
+    };
+
+    struct Result {
+        std::string_view benchmark;
+        std::string_view container;
+        std::string_view type;
+        size_t size = 0;
+        size_t items = 0;
+        size_t repetitions = 0;
+        uint64_t min_ns = 0;
+        double mean_ns = 0;
+    };
+
+    class Runner {
+    public:
+        explicit Runner(Options options)
+            : options_(std::move(options)) {
+        }
+
+        template <typename T>
+        void RunType() {
+            for (size_t size = 1; size <= options_.max_size; size *= 10) {
+                // Копирующему присваиванию нужны два контейнера, а std::vector растёт с запасом
+                if (size * Factory<T>::BYTES * 4 > options_.max_bytes) {
+                    break;
+                }
+                RunContainer<std::vector<T>, T>("std::vector", size);
+                RunContainer<Vector<T>, T>("Vector", size);
+            }
+        }
+
+        void Print(std::ostream& out) const {
+            if (options_.json) {
+                PrintJson(out);
+            }
+            else {
+                PrintCsv(out);
+            }
+        }
+
+    private:
+        template <typename C, typename T>
+        void RunContainer(std::string_view container, size_t size) {
+            const std::string_view type = Factory<T>::NAME;
+            Run("push_back", container, type, size, size, BenchPushBack<C, T>);
+            Run("emplace_back", container, type, size, size, BenchEmplaceBack<C, T>);
+            Run("insert_mid", container, type, size, MID_OPS, BenchInsertMid<C, T>);
+            Run("erase_mid", container, type, size, MID_OPS, BenchEraseMid<C, T>);
+            Run("reserve", container, type, size, size, BenchReserve<C, T>);
+            Run("copy_assign", container, type, size, size, BenchCopyAssign<C, T>);
+            Run("move", container, type, size, 1, BenchMove<C, T>);
+            if constexpr (std::is_arithmetic_v<T>) {
+                Run("find", container, type, size, size, BenchFind<C, T>);
+                Run("count", container, type, size, size, BenchCount<C, T>);
+            }
+        }
+
+        void Run(std::string_view benchmark, std::string_view container, std::string_view type,
+                 size_t size, size_t items, uint64_t (*bench)(size_t)) {
+            if (!options_.filter.empty() && benchmark.find(options_.filter) == std::string_view::npos) {
+                return;
+            }
+            const size_t MAX_REPETITIONS = 1000;
+            // Подготовка данных не замеряется, но тоже ограничивается по времени
+            const uint64_t max_wall_ns = options_.min_time_ns * 10;
+            const auto wall_start = Clock::now();
+
+            Result result{ benchmark, container, type, size, items };
+            result.min_ns = std::numeric_limits<uint64_t>::max();
+            uint64_t total_ns = 0;
+            do {
+                const uint64_t ns = bench(size);
+                total_ns += ns;
+                result.min_ns = std::min(result.min_ns, ns);
+                ++result.repetitions;
+            } while (total_ns < options_.min_time_ns && result.repetitions < MAX_REPETITIONS
+                     && ElapsedNs(wall_start) < max_wall_ns);
+            result.mean_ns = static_cast<double>(total_ns) / result.repetitions;
+            results_.push_back(result);
+        }
+
+        void PrintCsv(std::ostream& out) const {
+            out << "label,benchmark,container,type,size,items,repetitions,min_ns,mean_ns,ns_per_item\n";
+            for (const Result& r : results_) {
+                out << options_.label << ',' << r.benchmark << ',' << r.container << ',' << r.type << ','
+                    << r.size << ',' << r.items << ',' << r.repetitions << ',' << r.min_ns << ','
+                    << r.mean_ns << ',' << static_cast<double>(r.min_ns) / r.items << '\n';
+            }
+        }
+
+        void PrintJson(std::ostream& out) const {
+            out << "{\n  \"label\": \"" << options_.label << "\",\n  \"results\": [";
+            bool first = true;
+            for (const Result& r : results_) {
+                out << (first ? "\n" : ",\n");
+                first = false;
+                out << "    {\"benchmark\": \"" << r.benchmark << "\", \"container\": \"" << r.container
+                    << "\", \"type\": \"" << r.type << "\", \"size\": " << r.size << ", \"items\": " << r.items
+                    << ", \"repetitions\": " << r.repetitions << ", \"min_ns\": " << r.min_ns
+                    << ", \"mean_ns\": " << r.mean_ns
+                    << ", \"ns_per_item\": " << static_cast<double>(r.min_ns) / r.items << "}";
+            }
+            out << "\n  ]\n}\n";
+        }
+
+        Options options_;
+        std::vector<Result> results_;
+    };
+
+    Options ParseOptions(int argc, char* argv[]) {
+        using namespace std::literals;
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            const auto value = [&](std::string_view prefix) {
+                return std::string(arg.substr(prefix.size()));
+            };
+            if (arg == "--format=json"sv) {
+                options.json = true;
+            }
+            else if (arg == "--format=csv"sv) {
+                options.json = false;
+            }
+            else if (arg.substr(0, 9) == "--filter="sv) {
+                options.filter = value("--filter="sv);
+            }
+            else if (arg.substr(0, 8) == "--label="sv) {
+                options.label = value("--label="sv);
+            }
+            else if (arg.substr(0, 11) == "--max-size="sv) {
+                options.max_size = std::stoull(value("--max-size="sv));
+            }
+            else if (arg.substr(0, 12) == "--max-bytes="sv) {
+                options.max_bytes = std::stoull(value("--max-bytes="sv));
+            }
+            else if (arg.substr(0, 14) == "--min-time-ms="sv) {
+                options.min_time_ns = std::stoull(value("--min-time-ms="sv)) * 1'000'000;
+            }
+            else {
+                throw std::invalid_argument("Unknown option: "s + argv[i]);
+            }
+        }
+        return options;
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Runner runner(ParseOptions(argc, argv));
+        runner.RunType<int>();
+        runner.RunType<Pod64>();
+        runner.RunType<std::string>();
+        runner.RunType<ThrowingObj>();
+        runner.RunType<Handle>();
+        runner.Print(std::cout);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,224 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+
+// Вектор для одновременного добавления элементов из многих потоков. Элементы хранятся в сегментах
+// RawMemory, размер которых удваивается: сегмент k вмещает FIRST_SEGMENT << k элементов. Сегменты
+// никогда не перемещаются, поэтому ссылки на элементы остаются действительными до Freeze или Clear.
+// EmplaceBack не блокирует: место резервируется атомарным счётчиком, а новый сегмент
+// публикуется через compare_exchange (проигравший поток освобождает свой сегмент).
+// За элементами сегмента в том же блоке лежат флаги сконструированных элементов, поэтому
+// место, где конструктор выбросил исключение, остаётся пустым без выделения памяти.
+// Прочитать элемент из другого потока можно после того, как добавивший его EmplaceBack
+// завершился и это событие синхронизировано с читающим потоком (например, через передачу индекса).
+// Freeze, Clear и деструктор не должны выполняться одновременно с другими операциями
+template <typename T, typename Alloc = std::allocator<T>>
+class ConcurrentVector {
+    using Memory = RawMemory<T, Alloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    static constexpr size_t FIRST_SEGMENT_BITS = 6;
+    static constexpr size_t FIRST_SEGMENT = size_t{ 1 } << FIRST_SEGMENT_BITS;
+    static constexpr size_t MAX_SEGMENTS = sizeof(size_t) * 8 - FIRST_SEGMENT_BITS;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Alloc& alloc)
+        : alloc_(alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        Clear();
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        const auto [segment, offset] = Locate(index);
+        T* data = nullptr;
+        try {
+            data = segment_data_[segment].load(std::memory_order_acquire);
+            if (data == nullptr) {
+                data = InstallSegment(segment);
+            }
+            new (data + offset) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            // Место уже зарезервировано и остаётся пустым: его флаг не установлен
+            failed_.fetch_add(1, std::memory_order_relaxed);
+            throw;
+        }
+        // Флаг читают только Freeze, Clear и деструктор, синхронизированные с этим вызовом
+        Constructed(data, segment)[offset] = true;
+        // Следующий сегмент выделяется заранее, пока заполняется вторая половина текущего,
+        // чтобы потоки, дошедшие до границы, не ждали выделения памяти
+        if (offset == SegmentSize(segment) / 2 && segment + 1 < MAX_SEGMENTS
+            && segment_data_[segment + 1].load(std::memory_order_relaxed) == nullptr) {
+            try {
+                InstallSegment(segment + 1);
+            }
+            catch (...) {
+                // Не страшно: сегмент выделит первый поток, которому он понадобится
+            }
+        }
+        return data[offset];
+    }
+
+    T& PushBack(const T& value) {
+        return EmplaceBack(value);
+    }
+
+    T& PushBack(T&& value) {
+        return EmplaceBack(std::move(value));
+    }
+
+    // Количество зарезервированных мест, включая те, где элемент ещё конструируется
+    // или конструктор выбросил исключение
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        const auto [segment, offset] = Locate(index);
+        return segment_data_[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Переносит элементы в непрерывный Vector и очищает этот вектор.
+    // Места, где конструктор выбросил исключение, пропускаются
+    Vector<T, Alloc> Freeze() {
+        const size_t size = Size();
+        const size_t failed = failed_.load(std::memory_order_relaxed);
+        Vector<T, Alloc> result(alloc_);
+        result.Reserve(size - failed);
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>) {
+            if (failed == 0) {
+                // Сегменты копируются целиком в ещё не заполненную память
+                result.ResizeAndOverwrite(size, [this, size](T* dst, size_t /*size*/) {
+                    for (size_t segment = 0, begin = 0; begin < size; begin += SegmentSize(segment), ++segment) {
+                        const size_t count = std::min(SegmentSize(segment), size - begin);
+                        std::memcpy(static_cast<void*>(dst + begin),
+                                    segment_data_[segment].load(std::memory_order_relaxed), count * sizeof(T));
+                    }
+                    return size;
+                });
+                Clear();
+                return result;
+            }
+        }
+        for (size_t segment = 0, begin = 0; begin < size; begin += SegmentSize(segment), ++segment) {
+            T* data = segment_data_[segment].load(std::memory_order_relaxed);
+            // Сегмент не выделен, только если на всех его местах EmplaceBack завершился исключением
+            if (data == nullptr) {
+                continue;
+            }
+            const bool* constructed = Constructed(data, segment);
+            const size_t count = std::min(SegmentSize(segment), size - begin);
+            for (size_t i = 0; i < count; ++i) {
+                if (constructed[i]) {
+                    result.EmplaceBack(std::move_if_noexcept(data[i]));
+                }
+            }
+        }
+        Clear();
+        return result;
+    }
+
+    // Разрушает все элементы и освобождает сегменты
+    void Clear() noexcept {
+        const size_t size = Size();
+        for (size_t segment = 0, begin = 0; segment < MAX_SEGMENTS; begin += SegmentSize(segment), ++segment) {
+            T* data = segment_data_[segment].load(std::memory_order_relaxed);
+            if (data == nullptr) {
+                continue;
+            }
+            const bool* constructed = Constructed(data, segment);
+            const size_t count = begin < size ? std::min(SegmentSize(segment), size - begin) : 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (constructed[i]) {
+                    std::destroy_at(data + i);
+                }
+            }
+            Memory empty(alloc_);
+            segments_[segment].Swap(empty);
+            segment_data_[segment].store(nullptr, std::memory_order_relaxed);
+        }
+        failed_.store(0, std::memory_order_relaxed);
+        size_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    struct Location {
+        size_t segment;
+        size_t offset;
+    };
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return FIRST_SEGMENT << segment;
+    }
+
+    // Ёмкость блока сегмента в элементах T: сами элементы и по флагу bool на каждый
+    static constexpr size_t SegmentCapacity(size_t segment) noexcept {
+        return SegmentSize(segment) + (SegmentSize(segment) * sizeof(bool) + sizeof(T) - 1) / sizeof(T);
+    }
+
+    static bool* Constructed(T* data, size_t segment) noexcept {
+        return reinterpret_cast<bool*>(data + SegmentSize(segment));
+    }
+
+    // Индексы [FIRST_SEGMENT * (2^k - 1), FIRST_SEGMENT * (2^(k+1) - 1)) лежат в сегменте k
+    static Location Locate(size_t index) noexcept {
+        const size_t shifted = index + FIRST_SEGMENT;
+        const size_t segment = HighestBit(shifted) - FIRST_SEGMENT_BITS;
+        return { segment, shifted - SegmentSize(segment) };
+    }
+
+    static size_t HighestBit(size_t value) noexcept {
+        assert(value != 0);
+#if defined(__GNUC__)
+        return sizeof(unsigned long long) * 8 - 1 - static_cast<size_t>(__builtin_clzll(value));
+#else
+        size_t bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    // Выделяет сегмент и публикует его, если другой поток не успел раньше. Возвращает адрес сегмента
+    T* InstallSegment(size_t segment) {
+        Memory memory(SegmentCapacity(segment), alloc_);
+        std::uninitialized_fill_n(Constructed(memory.GetAddress(), segment), SegmentSize(segment), false);
+        T* expected = nullptr;
+        if (segment_data_[segment].compare_exchange_strong(expected, memory.GetAddress(), std::memory_order_acq_rel)) {
+            // Победитель единственный, а segments_ читают только Freeze, Clear и деструктор
+            segments_[segment].Swap(memory);
+            return segments_[segment].GetAddress();
+        }
+        return expected;
+    }
+
+    Alloc alloc_;
+    // Счётчик изменяется каждым EmplaceBack, поэтому занимает отдельную строку кэша
+    alignas(64) std::atomic<size_t> size_{ 0 };
+    alignas(64) std::atomic<T*> segment_data_[MAX_SEGMENTS] = {};
+    Memory segments_[MAX_SEGMENTS];
+    // Число мест, где EmplaceBack завершился исключением
+    std::atomic<size_t> failed_{ 0 };
+};
@@ -0,0 +1,245 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+
+// Вектор с копированием при записи. Копии разделяют один блок с атомарным счётчиком ссылок,
+// поэтому копирование стоит одного атомарного инкремента независимо от размера. Первый
+// изменяющий вызов на разделяемом блоке (в том числе неконстантные operator[], begin и end)
+// копирует элементы в собственный блок. Константные методы не трогают счётчик и не блокируют.
+// Разные объекты CowVector, разделяющие блок, можно использовать из разных потоков
+// одновременно; один объект, как и Vector, нельзя изменять одновременно с другими обращениями к нему.
+// Блок со счётчиком выделяется аллокатором Alloc, как и элементы. Копия получает аллокатор
+// через select_on_container_copy_construction и создаёт им собственный блок при первом изменении.
+// При присваивании и обмене аллокатор переходит вместе с блоком
+template <typename T, typename Alloc = std::allocator<T>>
+class CowVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    CowVector() = default;
+
+    explicit CowVector(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    // Забирает элементы vector без копирования
+    explicit CowVector(Vector<T, Alloc> vector)
+        : alloc_(vector.GetAllocator())
+        , block_(NewBlock(std::move(vector))) {
+    }
+
+    CowVector(std::initializer_list<T> init, const Alloc& alloc = Alloc())
+        : CowVector(Vector<T, Alloc>(init, alloc)) {
+    }
+
+    CowVector(const CowVector& other) noexcept
+        : alloc_(AllocTraits::select_on_container_copy_construction(other.alloc_))
+        , block_(other.block_) {
+        if (block_ != nullptr) {
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , block_(std::exchange(other.block_, nullptr)) {
+    }
+
+    CowVector& operator=(const CowVector& rhs) noexcept {
+        CowVector copy(rhs);
+        Swap(copy);
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        CowVector moved(std::move(rhs));
+        Swap(moved);
+        return *this;
+    }
+
+    ~CowVector() {
+        Release();
+    }
+
+    void Swap(CowVector& other) noexcept {
+        std::swap(alloc_, other.alloc_);
+        std::swap(block_, other.block_);
+    }
+
+    const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    const_iterator begin() const noexcept {
+        return block_ != nullptr ? block_->vector.begin() : nullptr;
+    }
+    const_iterator end() const noexcept {
+        return block_ != nullptr ? block_->vector.end() : nullptr;
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    iterator begin() {
+        return Unique(0).begin();
+    }
+    iterator end() {
+        return Unique(0).end();
+    }
+
+    size_t Size() const noexcept {
+        return block_ != nullptr ? block_->vector.Size() : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return block_ != nullptr ? block_->vector.Capacity() : 0;
+    }
+
+    const T* Data() const noexcept {
+        return begin();
+    }
+
+    VectorView<const T> AsView() const noexcept {
+        return VectorView<const T>(begin(), Size());
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return block_->vector[index];
+    }
+
+    T& operator[](size_t index) {
+        assert(index < Size());
+        return Unique(0)[index];
+    }
+
+    // Возвращает true, если блок разделяется с другими копиями
+    bool IsShared() const noexcept {
+        return block_ != nullptr && block_->refs.load(std::memory_order_acquire) != 1;
+    }
+
+    // Копия элементов в обычном Vector
+    Vector<T, Alloc> ToVector() const {
+        return block_ != nullptr ? block_->vector
+                                 : Vector<T, Alloc>(AllocTraits::select_on_container_copy_construction(alloc_));
+    }
+
+    void Reserve(size_t new_capacity) {
+        Unique(new_capacity > Size() ? new_capacity - Size() : 0).Reserve(new_capacity);
+    }
+
+    void Resize(size_t new_size) {
+        Unique(new_size > Size() ? new_size - Size() : 0).Resize(new_size);
+    }
+
+    // Разделяемый блок не копируется, а только отпускается
+    void Clear() noexcept {
+        if (IsShared()) {
+            Release();
+        }
+        else if (block_ != nullptr) {
+            block_->vector.Clear();
+        }
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return Unique(1).EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    void PopBack() {
+        Unique(0).PopBack();
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t pos_idx = pos - cbegin();
+        Vector<T, Alloc>& vector = Unique(1);
+        return vector.Emplace(vector.cbegin() + pos_idx, std::forward<Args>(args)...);
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t pos_idx = pos - cbegin();
+        Vector<T, Alloc>& vector = Unique(0);
+        return vector.Erase(vector.cbegin() + pos_idx);
+    }
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    struct Block {
+        explicit Block(Vector<T, Alloc>&& elements) noexcept
+            : vector(std::move(elements)) {
+        }
+
+        std::atomic<size_t> refs{ 1 };
+        Vector<T, Alloc> vector;
+    };
+
+    using BlockAlloc = typename AllocTraits::template rebind_alloc<Block>;
+    using BlockTraits = std::allocator_traits<BlockAlloc>;
+
+    // Блок выделяется аллокатором владельца, а освобождается аллокатором своих элементов:
+    // элементы блока всегда создаются с тем же alloc_, так что это копия выделившего аллокатора
+    Block* NewBlock(Vector<T, Alloc>&& elements) {
+        BlockAlloc block_alloc(alloc_);
+        Block* block = BlockTraits::allocate(block_alloc, 1);
+        BlockTraits::construct(block_alloc, block, std::move(elements));
+        return block;
+    }
+
+    // Гарантирует, что блок принадлежит только этому объекту, копируя разделяемый блок
+    // с местом ещё под extra элементов, чтобы следующая вставка не перевыделяла память
+    Vector<T, Alloc>& Unique(size_t extra) {
+        if (block_ == nullptr) {
+            block_ = NewBlock(Vector<T, Alloc>(alloc_));
+        }
+        // acquire синхронизируется с освобождением блока другими копиями, после чего
+        // их обращения к элементам завершены и блок можно изменять
+        else if (block_->refs.load(std::memory_order_acquire) != 1) {
+            const Vector<T, Alloc>& shared = block_->vector;
+            Vector<T, Alloc> copy(alloc_);
+            copy.Reserve(shared.Size() + extra);
+            copy.Append(shared.begin(), shared.end());
+            Block* unique = NewBlock(std::move(copy));
+            Release();
+            block_ = unique;
+        }
+        return block_->vector;
+    }
+
+    void Release() noexcept {
+        if (block_ != nullptr && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            BlockAlloc block_alloc(block_->vector.GetAllocator());
+            BlockTraits::destroy(block_alloc, block_);
+            BlockTraits::deallocate(block_alloc, block_, 1);
+        }
+        block_ = nullptr;
+    }
+
+    Alloc alloc_;
+    Block* block_ = nullptr;
+};
@@ -0,0 +1,299 @@
+#pragma once
+#include "vector.h"
+
+#include <utility>
+
+// Индекс первого элемента отсортированного массива data, не меньшего key. Двоичный поиск
+// без ветвлений: на каждом шаге выбирается одна из половин условным присваиванием,
+// поэтому нет промахов предсказателя переходов, а число шагов зависит только от size
+template <typename Key, typename K, typename Compare>
+size_t FlatLowerBound(const Key* data, size_t size, const K& key, const Compare& comp) {
+    if (size == 0) {
+        return 0;
+    }
+    const Key* base = data;
+    while (size > 1) {
+        const size_t half = size / 2;
+        base = comp(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return static_cast<size_t>(base - data) + (comp(*base, key) ? 1 : 0);
+}
+
+// Множество на отсортированном Vector ключей без повторов. Поиск выполняется двоичным поиском
+// по непрерывному массиву, вставка и удаление одного ключа сдвигают хвост, а InsertSorted
+// сливает отсортированный диапазон со множеством за один проход. Методы поиска принимают
+// любой тип K, сравнимый с ключами через Compare (std::less<> сравнивает std::string с std::string_view)
+template <typename Key, typename Compare = std::less<>>
+class FlatSet {
+public:
+    using value_type = Key;
+    using const_iterator = const Key*;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    const_iterator begin() const noexcept {
+        return keys_.begin();
+    }
+    const_iterator end() const noexcept {
+        return keys_.end();
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+    }
+
+    VectorView<const Key> Keys() const noexcept {
+        return keys_.AsView();
+    }
+
+    const Key& operator[](size_t index) const noexcept {
+        return keys_[index];
+    }
+
+    template <typename K>
+    size_t LowerBound(const K& key) const {
+        return FlatLowerBound(keys_.Data(), keys_.Size(), key, comp_);
+    }
+
+    // Указатель на ключ, равный key, или nullptr
+    template <typename K>
+    const Key* Find(const K& key) const {
+        const size_t index = LowerBound(key);
+        return index < keys_.Size() && !comp_(key, keys_[index]) ? &keys_[index] : nullptr;
+    }
+
+    template <typename K>
+    bool Contains(const K& key) const {
+        return Find(key) != nullptr;
+    }
+
+    // Возвращает false, если такой ключ уже есть
+    template <typename K>
+    bool Insert(K&& key) {
+        const size_t index = LowerBound(key);
+        if (index < keys_.Size() && !comp_(key, keys_[index])) {
+            return false;
+        }
+        keys_.Emplace(keys_.begin() + index, std::forward<K>(key));
+        return true;
+    }
+
+    // Сливает диапазон ключей, отсортированный по Compare, с множеством за O(Size() + длина диапазона).
+    // Повторяющиеся ключи добавляются один раз. При исключении множество очищается
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    void InsertSorted(InputIt first, InputIt last) {
+        Vector<Key> merged;
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            merged.Reserve(keys_.Size() + std::distance(first, last));
+        }
+        try {
+            size_t old = 0;
+            for (; first != last; ++first) {
+                const auto& key = *first;
+                while (old < keys_.Size() && comp_(keys_[old], key)) {
+                    merged.PushBack(std::move(keys_[old++]));
+                }
+                const bool present = old < keys_.Size() && !comp_(key, keys_[old]);
+                const bool repeated = merged.Size() != 0 && !comp_(merged[merged.Size() - 1], key);
+                if (!present && !repeated) {
+                    merged.EmplaceBack(key);
+                }
+            }
+            merged.Append(std::make_move_iterator(keys_.begin() + old), std::make_move_iterator(keys_.end()));
+        }
+        catch (...) {
+            keys_.Clear();
+            throw;
+        }
+        keys_.Swap(merged);
+    }
+
+    // Возвращает количество удалённых ключей (0 или 1)
+    template <typename K>
+    size_t Erase(const K& key) {
+        const Key* found = Find(key);
+        if (found == nullptr) {
+            return 0;
+        }
+        keys_.Erase(found);
+        return 1;
+    }
+
+private:
+    Vector<Key> keys_;
+    Compare comp_;
+};
+
+// Ассоциативный массив на двух параллельных Vector: отсортированных ключей и значений.
+// Поиск читает только плотный массив ключей, а значение берётся по найденному индексу.
+// Вставка и удаление одной пары сдвигают хвосты обоих массивов, InsertSorted сливает
+// отсортированный диапазон пар за один проход. Указатели на значения действительны
+// до следующего изменения контейнера
+template <typename Key, typename Value, typename Compare = std::less<>>
+class FlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+        values_.Reserve(capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+    }
+
+    // Ключи по возрастанию и значения в том же порядке
+    VectorView<const Key> Keys() const noexcept {
+        return keys_.AsView();
+    }
+    VectorView<Value> Values() noexcept {
+        return values_.AsView();
+    }
+    VectorView<const Value> Values() const noexcept {
+        return values_.AsView();
+    }
+
+    template <typename K>
+    size_t LowerBound(const K& key) const {
+        return FlatLowerBound(keys_.Data(), keys_.Size(), key, comp_);
+    }
+
+    // Указатель на значение для ключа key или nullptr
+    template <typename K>
+    Value* Find(const K& key) {
+        const size_t index = LowerBound(key);
+        return index < keys_.Size() && !comp_(key, keys_[index]) ? &values_[index] : nullptr;
+    }
+
+    template <typename K>
+    const Value* Find(const K& key) const {
+        return const_cast<FlatMap&>(*this).Find(key);
+    }
+
+    template <typename K>
+    bool Contains(const K& key) const {
+        return Find(key) != nullptr;
+    }
+
+    // Конструирует значение из args, если ключа нет. Возвращает значение для ключа
+    // и признак того, что пара была добавлена
+    template <typename K, typename... Args>
+    std::pair<Value*, bool> TryEmplace(K&& key, Args&&... args) {
+        const size_t index = LowerBound(key);
+        if (index < keys_.Size() && !comp_(key, keys_[index])) {
+            return { &values_[index], false };
+        }
+        values_.Emplace(values_.begin() + index, std::forward<Args>(args)...);
+        try {
+            keys_.Emplace(keys_.begin() + index, std::forward<K>(key));
+        }
+        catch (...) {
+            values_.Erase(values_.begin() + index);
+            throw;
+        }
+        return { &values_[index], true };
+    }
+
+    template <typename K>
+    std::pair<Value*, bool> Insert(K&& key, const Value& value) {
+        return TryEmplace(std::forward<K>(key), value);
+    }
+
+    template <typename K>
+    std::pair<Value*, bool> Insert(K&& key, Value&& value) {
+        return TryEmplace(std::forward<K>(key), std::move(value));
+    }
+
+    // Значение для ключа key, при отсутствии ключа добавляется значение по умолчанию
+    template <typename K>
+    Value& operator[](K&& key) {
+        return *TryEmplace(std::forward<K>(key)).first;
+    }
+
+    // Сливает диапазон пар (first - ключ, second - значение), отсортированный по ключам, с контейнером
+    // за O(Size() + длина диапазона). Для имеющихся и повторяющихся ключей сохраняется первое значение.
+    // При исключении контейнер очищается
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    void InsertSorted(InputIt first, InputIt last) {
+        Vector<Key> merged_keys;
+        Vector<Value> merged_values;
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            const size_t size = keys_.Size() + std::distance(first, last);
+            merged_keys.Reserve(size);
+            merged_values.Reserve(size);
+        }
+        try {
+            size_t old = 0;
+            const auto take_old = [&] {
+                merged_keys.PushBack(std::move(keys_[old]));
+                merged_values.PushBack(std::move(values_[old]));
+                ++old;
+            };
+            for (; first != last; ++first) {
+                const auto& entry = *first;
+                while (old < keys_.Size() && comp_(keys_[old], entry.first)) {
+                    take_old();
+                }
+                const bool present = old < keys_.Size() && !comp_(entry.first, keys_[old]);
+                const bool repeated = merged_keys.Size() != 0
+                                      && !comp_(merged_keys[merged_keys.Size() - 1], entry.first);
+                if (!present && !repeated) {
+                    merged_keys.EmplaceBack(entry.first);
+                    merged_values.EmplaceBack(entry.second);
+                }
+            }
+            while (old < keys_.Size()) {
+                take_old();
+            }
+        }
+        catch (...) {
+            Clear();
+            throw;
+        }
+        keys_.Swap(merged_keys);
+        values_.Swap(merged_values);
+    }
+
+    // Возвращает количество удалённых пар (0 или 1)
+    template <typename K>
+    size_t Erase(const K& key) {
+        const size_t index = LowerBound(key);
+        if (index == keys_.Size() || comp_(key, keys_[index])) {
+            return 0;
+        }
+        keys_.Erase(keys_.begin() + index);
+        values_.Erase(values_.begin() + index);
+        return 1;
+    }
+
+private:
+    Vector<Key> keys_;
+    Vector<Value> values_;
+    Compare comp_;
+};
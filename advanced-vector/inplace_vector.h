@@ -0,0 +1,286 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Наименьший беззнаковый тип, вмещающий число от 0 до N
+template <size_t N>
+using InplaceSizeType = std::conditional_t<N <= UINT8_MAX, uint8_t,
+                        std::conditional_t<N <= UINT16_MAX, uint16_t,
+                        std::conditional_t<N <= UINT32_MAX, uint32_t, size_t>>>;
+
+// Хранилище InplaceVector. Для тривиальных T это обычный массив: все его ячейки - живые объекты,
+// поэтому вставка и удаление сводятся к присваиваниям и доступны в constexpr
+template <typename T, size_t N, bool = std::is_trivial_v<T>>
+class InplaceVectorStorage {
+protected:
+    constexpr T* Data() noexcept {
+        return data_;
+    }
+    constexpr const T* Data() const noexcept {
+        return data_;
+    }
+
+    template <typename... Args>
+    constexpr void ConstructAt(size_t index, Args&&... args) {
+        data_[index] = T(std::forward<Args>(args)...);
+    }
+
+    constexpr void DestroyAt(size_t /*index*/) noexcept {
+    }
+
+    constexpr void DestroyAll() noexcept {
+    }
+
+    T data_[N] = {};
+    InplaceSizeType<N> size_ = 0;
+};
+
+// Для остальных T элементы конструируются в сыром буфере. Копирование и разрушение
+// добавляет InplaceVectorLifetime, если T не тривиально копируем
+template <typename T, size_t N>
+class InplaceVectorStorage<T, N, false> {
+protected:
+    T* Data() noexcept {
+        return std::launder(reinterpret_cast<T*>(buffer_));
+    }
+    const T* Data() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(buffer_));
+    }
+
+    template <typename... Args>
+    void ConstructAt(size_t index, Args&&... args) {
+        new (buffer_ + index * sizeof(T)) T(std::forward<Args>(args)...);
+    }
+
+    void DestroyAt(size_t index) noexcept {
+        std::destroy_at(Data() + index);
+    }
+
+    void DestroyAll() noexcept {
+        std::destroy_n(Data(), size_);
+    }
+
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+    InplaceSizeType<N> size_ = 0;
+};
+
+// Тривиально копируемые T копируются вместе с буфером, и сам вектор остаётся тривиально копируемым
+template <typename T, size_t N, bool = std::is_trivially_copyable_v<T>>
+class InplaceVectorLifetime : public InplaceVectorStorage<T, N> {
+};
+
+template <typename T, size_t N>
+class InplaceVectorLifetime<T, N, false> : public InplaceVectorStorage<T, N> {
+    using Storage = InplaceVectorStorage<T, N>;
+
+public:
+    InplaceVectorLifetime() = default;
+
+    InplaceVectorLifetime(const InplaceVectorLifetime& other) {
+        std::uninitialized_copy_n(other.Data(), other.size_, this->Data());
+        this->size_ = other.size_;
+    }
+
+    InplaceVectorLifetime(InplaceVectorLifetime&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        std::uninitialized_move_n(other.Data(), other.size_, this->Data());
+        this->size_ = other.size_;
+    }
+
+    InplaceVectorLifetime& operator=(const InplaceVectorLifetime& rhs) {
+        if (this != &rhs) {
+            Assign(rhs.Data(), rhs.size_);
+        }
+        return *this;
+    }
+
+    InplaceVectorLifetime& operator=(InplaceVectorLifetime&& rhs) noexcept(
+        std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+        if (this != &rhs) {
+            Assign(std::make_move_iterator(rhs.Data()), rhs.size_);
+        }
+        return *this;
+    }
+
+    ~InplaceVectorLifetime() {
+        Storage::DestroyAll();
+    }
+
+private:
+    // Общая часть присваивается, лишние элементы разрушаются, недостающие конструируются
+    template <typename InputIt>
+    void Assign(InputIt src, size_t count) {
+        T* data = this->Data();
+        const size_t common = std::min<size_t>(count, this->size_);
+        for (size_t i = 0; i < common; ++i, ++src) {
+            data[i] = *src;
+        }
+        if (count < this->size_) {
+            std::destroy_n(data + count, this->size_ - count);
+        }
+        else {
+            std::uninitialized_copy_n(src, count - common, data + common);
+        }
+        this->size_ = static_cast<InplaceSizeType<N>>(count);
+    }
+};
+
+// Вектор фиксированной ёмкости N с элементами внутри объекта, без обращений к куче.
+// Интерфейс совпадает с Vector. Добавление сверх ёмкости выбрасывает std::bad_alloc,
+// а TryEmplaceBack вместо этого возвращает nullptr. Для тривиальных T вектор можно
+// заполнять в constexpr, а для тривиально копируемых T он сам тривиально копируем
+// и передаётся между потоками через memcpy
+template <typename T, size_t N>
+class InplaceVector : public InplaceVectorLifetime<T, N> {
+    static_assert(N > 0, "Capacity must be positive");
+
+    using Storage = InplaceVectorStorage<T, N>;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t CAPACITY = N;
+
+    constexpr InplaceVector() noexcept = default;
+
+    explicit constexpr InplaceVector(size_t size) {
+        Resize(size);
+    }
+
+    constexpr iterator begin() noexcept {
+        return this->Data();
+    }
+    constexpr iterator end() noexcept {
+        return this->Data() + this->size_;
+    }
+    constexpr const_iterator begin() const noexcept {
+        return this->Data();
+    }
+    constexpr const_iterator end() const noexcept {
+        return this->Data() + this->size_;
+    }
+    constexpr const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    constexpr const_iterator cend() const noexcept {
+        return end();
+    }
+
+    constexpr void Resize(size_t new_size) {
+        if (new_size > N) {
+            throw std::bad_alloc();
+        }
+        while (this->size_ > new_size) {
+            PopBack();
+        }
+        while (this->size_ < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    constexpr void Clear() noexcept {
+        Storage::DestroyAll();
+        this->size_ = 0;
+    }
+
+    constexpr void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    constexpr void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    constexpr void PopBack() noexcept {
+        assert(this->size_ > 0);
+        --this->size_;
+        Storage::DestroyAt(this->size_);
+    }
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        T* elem = TryEmplaceBack(std::forward<Args>(args)...);
+        if (elem == nullptr) {
+            throw std::bad_alloc();
+        }
+        return *elem;
+    }
+
+    // Добавляет элемент, если есть место, и возвращает указатель на него, иначе nullptr
+    template <typename... Args>
+    constexpr T* TryEmplaceBack(Args&&... args) {
+        if (this->size_ == N) {
+            return nullptr;
+        }
+        Storage::ConstructAt(this->size_, std::forward<Args>(args)...);
+        return this->Data() + this->size_++;
+    }
+
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    constexpr iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t pos_idx = pos - cbegin();
+        assert(pos_idx <= this->size_);
+        if (this->size_ == N) {
+            throw std::bad_alloc();
+        }
+        T* data = this->Data();
+        if (pos_idx == this->size_) {
+            Storage::ConstructAt(pos_idx, std::forward<Args>(args)...);
+        }
+        else {
+            // Временный объект создаётся до сдвига, так как args могут ссылаться на элементы вектора
+            T tmp(std::forward<Args>(args)...);
+            Storage::ConstructAt(this->size_, std::move(data[this->size_ - 1]));
+            for (size_t i = this->size_ - 1; i > pos_idx; --i) {
+                data[i] = std::move(data[i - 1]);
+            }
+            data[pos_idx] = std::move(tmp);
+        }
+        ++this->size_;
+        return data + pos_idx;
+    }
+
+    constexpr iterator Erase(const_iterator pos) {
+        const size_t pos_idx = pos - cbegin();
+        assert(pos_idx < this->size_);
+        T* data = this->Data();
+        for (size_t i = pos_idx + 1; i < this->size_; ++i) {
+            data[i - 1] = std::move(data[i]);
+        }
+        PopBack();
+        return data + pos_idx;
+    }
+
+    constexpr size_t Size() const noexcept {
+        return this->size_;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        assert(index < this->size_);
+        return this->Data()[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < this->size_);
+        return this->Data()[index];
+    }
+};
@@ -1,11 +1,40 @@
+#include "arena_allocator.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "flat_map.h"
+#include "inplace_vector.h"
+#include "mmap_allocator.h"
+#include "numa_allocator.h"
+#if defined(VECTOR_HAS_MMAP)
+#include "mapped_vector.h"
+#endif
+#include "sharded_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
 #include "vector.h"
+#include "vector_algorithms.h"
+#include "vector_io.h"
+#include "vector_parallel.h"
+#include "vector_stats.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#if defined(VECTOR_HAS_FD_IO)
+#include <fcntl.h>
+#endif
+
 namespace {
 
     // "Магическое" число, используемое для отслеживания живости объекта
@@ -117,8 +146,363 @@ namespace {
         static inline int num_move_assigned = 0;
     };
 
+    // Счётчики операций с памятью одного "пула", к которому привязан аллокатор
+    struct AllocStats {
+        int num_allocations = 0;
+        int num_deallocations = 0;
+        size_t bytes_allocated = 0;
+    };
+
+    // Тип, перемещающее присваивание которого выбрасывает исключение по счётчику
+    struct ThrowingMoveAssign {
+        ThrowingMoveAssign(int value = 0)
+            : value(value) {
+            ++alive;
+        }
+        ThrowingMoveAssign(const ThrowingMoveAssign& other)
+            : value(other.value) {
+            ++alive;
+        }
+        ThrowingMoveAssign& operator=(const ThrowingMoveAssign&) = default;
+        ThrowingMoveAssign& operator=(ThrowingMoveAssign&& other) {
+            if (move_assign_throw_countdown > 0 && --move_assign_throw_countdown == 0) {
+                throw std::runtime_error("move assign failed");
+            }
+            value = other.value;
+            return *this;
+        }
+        ~ThrowingMoveAssign() {
+            --alive;
+        }
+
+        int value;
+
+        static inline int alive = 0;
+        static inline int move_assign_throw_countdown = 0;
+    };
+
+    // Тип без копирования, перемещающий конструктор которого выбрасывает исключение по счётчику
+    struct ThrowingMoveOnly {
+        explicit ThrowingMoveOnly(int value)
+            : value(value) {
+            ++alive;
+        }
+        ThrowingMoveOnly(const ThrowingMoveOnly&) = delete;
+        ThrowingMoveOnly(ThrowingMoveOnly&& other)
+            : value(other.value) {
+            if (move_throw_countdown > 0 && --move_throw_countdown == 0) {
+                throw std::runtime_error("move failed");
+            }
+            ++alive;
+        }
+        ThrowingMoveOnly& operator=(const ThrowingMoveOnly&) = delete;
+        ThrowingMoveOnly& operator=(ThrowingMoveOnly&&) = default;
+        ~ThrowingMoveOnly() {
+            --alive;
+        }
+
+        int value;
+
+        static inline int alive = 0;
+        static inline int move_throw_countdown = 0;
+    };
+
+    // Аллокатор с состоянием: экземпляры равны, только если привязаны к одному пулу
+    template <typename T, bool Propagate>
+    struct StatefulAllocator {
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+        using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+        using propagate_on_container_swap = std::bool_constant<Propagate>;
+        using is_always_equal = std::false_type;
+
+        template <typename U>
+        struct rebind {
+            using other = StatefulAllocator<U, Propagate>;
+        };
+
+        explicit StatefulAllocator(AllocStats* stats) noexcept
+            : stats(stats) {
+        }
+
+        template <typename U>
+        StatefulAllocator(const StatefulAllocator<U, Propagate>& other) noexcept
+            : stats(other.stats) {
+        }
+
+        T* allocate(size_t n) {
+            ++stats->num_allocations;
+            stats->bytes_allocated += n * sizeof(T);
+            return static_cast<T*>(operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t /*n*/) noexcept {
+            ++stats->num_deallocations;
+            operator delete(p);
+        }
+
+        bool operator==(const StatefulAllocator& other) const noexcept {
+            return stats == other.stats;
+        }
+        bool operator!=(const StatefulAllocator& other) const noexcept {
+            return stats != other.stats;
+        }
+
+        AllocStats* stats;
+    };
+
+    // Выделение с номером allocation_failure_countdown (начиная с 1) выбрасывает std::bad_alloc
+    inline int allocation_failure_countdown = 0;
+
+    template <typename T>
+    struct FailingAllocator {
+        using value_type = T;
+
+        FailingAllocator() = default;
+
+        template <typename U>
+        FailingAllocator(const FailingAllocator<U>&) noexcept {
+        }
+
+        T* allocate(size_t n) {
+            if (allocation_failure_countdown > 0 && --allocation_failure_countdown == 0) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t /*n*/) noexcept {
+            operator delete(p);
+        }
+
+        bool operator==(const FailingAllocator&) const noexcept {
+            return true;
+        }
+        bool operator!=(const FailingAllocator&) const noexcept {
+            return false;
+        }
+    };
+
+    // Тип с нетривиальными перемещением и деструктором, помеченный как тривиально перемещаемый
+    struct RelocObj {
+        RelocObj() = default;
+        explicit RelocObj(int id)
+            : id(id) {
+        }
+        RelocObj(const RelocObj& other)
+            : id(other.id) {
+            ++num_copied;
+        }
+        RelocObj(RelocObj&& other) noexcept
+            : id(std::exchange(other.id, 0)) {
+            ++num_moved;
+        }
+        RelocObj& operator=(RelocObj&& other) noexcept {
+            id = std::exchange(other.id, 0);
+            return *this;
+        }
+        ~RelocObj() {
+            ++num_destroyed;
+        }
+
+        static void ResetCounters() {
+            num_copied = 0;
+            num_moved = 0;
+            num_destroyed = 0;
+        }
+
+        int id = 0;
+
+        static inline int num_copied = 0;
+        static inline int num_moved = 0;
+        static inline int num_destroyed = 0;
+    };
+
+    // Аллокатор, выделяющий блоки с запасом и расширяющий их на месте в пределах запаса
+    template <typename T>
+    struct ExpandableAllocator {
+        using value_type = T;
+
+        static constexpr size_t RESERVED = 80;
+
+        ExpandableAllocator() = default;
+
+        template <typename U>
+        ExpandableAllocator(const ExpandableAllocator<U>&) noexcept {
+        }
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(operator new(std::max(n, RESERVED) * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t /*n*/) noexcept {
+            operator delete(p);
+        }
+
+        bool try_expand(T* /*p*/, size_t /*old_n*/, size_t new_n) noexcept {
+            if (new_n > RESERVED) {
+                return false;
+            }
+            ++num_expanded;
+            return true;
+        }
+
+        bool operator==(const ExpandableAllocator&) const noexcept {
+            return true;
+        }
+        bool operator!=(const ExpandableAllocator&) const noexcept {
+            return false;
+        }
+
+        static inline int num_expanded = 0;
+    };
+
+    // Сверяет векторные алгоритмы с std:: на всех длинах (включая хвосты короче регистра)
+    // и на каждой позиции искомого значения
+    template <typename T>
+    void CheckSimdAlgorithms() {
+        const size_t MAX_SIZE = 300;
+        uint32_t seed = 12345;
+        const auto next = [&seed] {
+            seed = seed * 1103515245 + 12345;
+            return static_cast<T>((seed >> 16) % 100) - static_cast<T>(50);
+        };
+        for (size_t size = 0; size <= MAX_SIZE; size += size < 70 ? 1 : 23) {
+            Vector<T> v(size);
+            for (T& x : v) {
+                x = next();
+            }
+            const Vector<T>& cv = v;
+            for (const T value : { T(0), T(7), T(120) }) {
+                assert(Find(cv, value) == std::find(v.begin(), v.end(), value));
+                assert(Count(cv, value) == static_cast<size_t>(std::count(v.begin(), v.end(), value)));
+            }
+            assert(MinElement(cv) == std::min_element(v.begin(), v.end()));
+            assert(MaxElement(cv) == std::max_element(v.begin(), v.end()));
+            if (size != 0) {
+                // Крайние значения типа в первой трети и в конце диапазона
+                v[size / 3] = std::numeric_limits<T>::max();
+                v[size - 1] = std::numeric_limits<T>::lowest();
+                assert(MinElement(v) == std::min_element(v.begin(), v.end()));
+                assert(MaxElement(v) == std::max_element(v.begin(), v.end()));
+                assert(*MinElement(v) == std::numeric_limits<T>::lowest());
+                assert(Find(v, std::numeric_limits<T>::max()) == std::find(v.begin(), v.end(), std::numeric_limits<T>::max()));
+            }
+            if constexpr (std::is_floating_point_v<T>) {
+                // Результат с NaN совпадает с последовательным поиском при любом положении NaN
+                for (const size_t pos : { size_t{ 0 }, size / 2, size - 1 }) {
+                    if (pos < size) {
+                        Vector<T> nans = v;
+                        nans[pos] = std::numeric_limits<T>::quiet_NaN();
+                        assert(MinElement(nans) == nans.begin() + (std::min_element(nans.begin(), nans.end()) - nans.begin()));
+                        assert(MaxElement(nans) == nans.begin() + (std::max_element(nans.begin(), nans.end()) - nans.begin()));
+                    }
+                }
+            }
+            Fill(v, T(3));
+            assert(Count(cv, T(3)) == size);
+        }
+    }
+
+    // Выделения через глобальный operator new в текущем потоке. Счётчики свои у каждого потока,
+    // поэтому фоновые потоки пула не влияют на проверки
+    thread_local size_t num_global_allocations = 0;
+    thread_local size_t num_global_deallocations = 0;
+
+    // Считает выделения и освобождения глобальной памяти текущим потоком с момента создания
+    class AllocationCounter {
+    public:
+        size_t Allocations() const noexcept {
+            return num_global_allocations - allocations_;
+        }
+
+        size_t Deallocations() const noexcept {
+            return num_global_deallocations - deallocations_;
+        }
+
+    private:
+        size_t allocations_ = num_global_allocations;
+        size_t deallocations_ = num_global_deallocations;
+    };
+
 }  // namespace
 
+// Подменённые глобальные operator new и delete считают вызовы. Подменяются все невыровненные
+// формы, чтобы память, выделенная любой из них, освобождалась парной. Выровненные формы
+// (AlignedAllocator, RawMemory с выравниванием больше стандартного) не подменяются и не считаются.
+// Встроенный в место вызова free GCC принимает за освобождение чужой памяти, поэтому noinline
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    ++num_global_allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    if (p != nullptr) {
+        ++num_global_deallocations;
+    }
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t /*size*/) noexcept {
+    operator delete(p);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p, const std::nothrow_t& /*tag*/) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t /*size*/) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t& /*tag*/) noexcept {
+    operator delete(p);
+}
+
+template <>
+struct IsTriviallyRelocatable<RelocObj> : std::true_type {
+};
+
+template <>
+struct VectorCodec<Obj> {
+    static void Write(std::ostream& out, const Obj& value) {
+        out.write(reinterpret_cast<const char*>(&value.id), sizeof(value.id));
+        VectorCodec<std::string>::Write(out, value.name);
+    }
+
+    static Obj Read(std::istream& in) {
+        int id = 0;
+        if (!in.read(reinterpret_cast<char*>(&id), sizeof(id))) {
+            throw std::runtime_error("Unexpected end of vector stream");
+        }
+        return Obj(id, VectorCodec<std::string>::Read(in));
+    }
+};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -564,86 +948,2021 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+void Test7() {
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        AllocStats stats;
+        {
+            using Alloc = StatefulAllocator<Obj, true>;
+            Vector<Obj, Alloc> v(SIZE, Alloc(&stats));
+            v.Reserve(SIZE * 2);
+            assert(stats.num_allocations == 2);
+            assert(stats.num_deallocations == 1);
+            assert(stats.bytes_allocated == SIZE * 3 * sizeof(Obj));
+            const auto v_copy(v);
+            assert(v_copy.GetAllocator() == v.GetAllocator());
+            assert(stats.num_allocations == 3);
+        }
+        assert(stats.num_allocations == stats.num_deallocations);
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+    {
+        // Копирующее присваивание с propagate_on_container_copy_assignment
+        Obj::ResetCounters();
+        AllocStats stats1;
+        AllocStats stats2;
+        {
+            using Alloc = StatefulAllocator<Obj, true>;
+            Vector<Obj, Alloc> v1(SIZE, Alloc(&stats1));
+            Vector<Obj, Alloc> v2(SIZE / 2, Alloc(&stats2));
+            v1 = v2;
+            assert(v1.GetAllocator() == Alloc(&stats2));
+            assert(v1.Size() == SIZE / 2);
+            assert(stats1.num_deallocations == 1);
+            assert(stats2.num_allocations == 2);
+            assert(Obj::GetAliveObjectCount() == SIZE);
+        }
+        assert(stats1.num_allocations == stats1.num_deallocations);
+        assert(stats2.num_allocations == stats2.num_deallocations);
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+    {
+        // Перемещающее присваивание и обмен без распространения аллокаторов
+        Obj::ResetCounters();
+        AllocStats stats1;
+        AllocStats stats2;
+        {
+            using Alloc = StatefulAllocator<Obj, false>;
+            Vector<Obj, Alloc> v1(SIZE / 2, Alloc(&stats1));
+            Vector<Obj, Alloc> v2(SIZE, Alloc(&stats2));
+            v1 = std::move(v2);
+            assert(v1.GetAllocator() == Alloc(&stats1));
+            assert(v1.Size() == SIZE);
+            assert(Obj::num_moved == SIZE);
+            assert(stats1.num_allocations == 2);
+            assert(stats2.num_allocations == 1);
+
+            Vector<Obj, Alloc> v3(SIZE, Alloc(&stats1));
+            v1.Swap(v3);
+            assert(v1.GetAllocator() == Alloc(&stats1));
+            assert(v3.GetAllocator() == Alloc(&stats1));
+        }
+        assert(stats1.num_allocations == stats1.num_deallocations);
+        assert(stats2.num_allocations == stats2.num_deallocations);
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+    {
+        // Перемещающее присваивание освобождает прежние элементы и память
+        Obj::ResetCounters();
+        AllocStats stats;
+        {
+            using Alloc = StatefulAllocator<Obj, true>;
+            Vector<Obj, Alloc> v1(SIZE, Alloc(&stats));
+            Vector<Obj, Alloc> v2(SIZE, Alloc(&stats));
+            v1 = std::move(v2);
+            assert(Obj::GetAliveObjectCount() == SIZE);
+            assert(Obj::num_moved == 0);
+            assert(stats.num_deallocations == 1);
         }
-        return *this;
+        assert(stats.num_allocations == stats.num_deallocations);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test8() {
+    const size_t SIZE = 100;
+    {
+        RelocObj::ResetCounters();
+        Vector<RelocObj> v(SIZE);
+        v[SIZE - 1].id = 42;
+        v.Reserve(SIZE * 2);
+        assert(v.Capacity() == SIZE * 2);
+        assert(v[SIZE - 1].id == 42);
+        assert(RelocObj::num_moved == 0);
+        assert(RelocObj::num_destroyed == 0);
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+    {
+        RelocObj::ResetCounters();
+        Vector<RelocObj> v(SIZE);
+        v.Emplace(v.cbegin() + 1, 7);
+        v.EmplaceBack(8);
+        assert(v.Size() == SIZE + 2);
+        assert(v[1].id == 7);
+        assert(v[SIZE + 1].id == 8);
+        assert(RelocObj::num_moved == 0);
+        assert(RelocObj::num_destroyed == 0);
     }
-    ~C() {
-        ++dtor;
+    {
+        Vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.PushBack(std::make_unique<int>(i));
+        }
+        assert(*v[SIZE - 1] == static_cast<int>(SIZE - 1));
+        v.Insert(v.cbegin(), std::make_unique<int>(-1));
+        assert(*v[0] == -1 && *v[SIZE] == static_cast<int>(SIZE - 1));
     }
+}
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+void Test9() {
+    {
+        Obj::ResetCounters();
+        Vector<Obj, ExpandableAllocator<Obj>> v(10);
+        const Obj* data = &v[0];
+        v.Reserve(20);
+        assert(v.Capacity() == 20);
+        assert(&v[0] == data);
+        while (v.Size() < ExpandableAllocator<Obj>::RESERVED) {
+            v.PushBack(v[0]);
+        }
+        assert(&v[0] == data);
+        assert(Obj::num_moved == 0);
+        assert(ExpandableAllocator<Obj>::num_expanded == 3);
+        v.PushBack(Obj{ 1 });
+        assert(&v[0] != data);
+        assert(v.Size() == ExpandableAllocator<Obj>::RESERVED + 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        const int SIZE = 1000;
+        RelocObj::ResetCounters();
+        Vector<RelocObj, ReallocAllocator<RelocObj>> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Insert(v.cbegin() + 1, RelocObj{ -1 });
+        while (v.Size() != v.Capacity()) {
+            v.EmplaceBack(0);
+        }
+        const int old_num_moved = RelocObj::num_moved;
+        // Вставка ссылки на собственный элемент при перевыделении через realloc
+        v.PushBack(v[2]);
+        assert(v[0].id == 0 && v[1].id == -1 && v[2].id == 1 && v[SIZE].id == SIZE - 1);
+        assert(v[v.Size() - 1].id == 1);
+        assert(RelocObj::num_copied == 1);
+        assert(RelocObj::num_moved == old_num_moved);
+        v.Reserve(v.Capacity() * 4);
+        assert(v[SIZE].id == SIZE - 1);
     }
+}
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+void Test10() {
+    {
+        Vector<int, std::allocator<int>, FactorGrowth<3, 2>> v;
+        std::vector<size_t> capacities;
+        for (int i = 0; i < 20; ++i) {
+            if (v.Size() == v.Capacity()) {
+                v.PushBack(i);
+                capacities.push_back(v.Capacity());
+            }
+            else {
+                v.PushBack(i);
+            }
+        }
+        assert((capacities == std::vector<size_t>{ 1, 2, 3, 4, 6, 9, 13, 19, 28 }));
+        assert(v[19] == 19);
+    }
+    {
+        Vector<int, std::allocator<int>, MinInitialGrowth<>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == 64 / sizeof(int));
+        while (v.Size() != v.Capacity()) {
+            v.PushBack(1);
+        }
+        v.EmplaceBack(2);
+        assert(v.Capacity() == 2 * 64 / sizeof(int));
+    }
+    {
+        using Growth = SizeClassGrowth<FactorGrowth<3, 2>>;
+        assert(Growth::RoundToSizeClass(1) == 16);
+        assert(Growth::RoundToSizeClass(17) == 20);
+        assert(Growth::RoundToSizeClass(100) == 112);
+        assert(Growth::RoundToSizeClass(4096) == 4096);
+        assert(Growth::RoundToSizeClass(4097) == 5120);
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-        << ", Copy ctors: "sv << C::copy_ctor          //
-        << ", Move ctors: "sv << C::move_ctor          //
-        << ", Copy assignments: "sv << C::copy_assign  //
-        << ", Move assignments: "sv << C::move_assign  //
-        << ", Dtors: "sv << C::dtor << endl;
+        // Ёмкость в полтора раза больше, округлённая до размерного класса
+        Vector<char, std::allocator<char>, Growth> v;
+        std::vector<size_t> capacities;
+        for (int i = 0; i < 200; ++i) {
+            if (v.Size() == v.Capacity()) {
+                v.PushBack('a');
+                capacities.push_back(v.Capacity());
+            }
+            else {
+                v.Insert(v.cbegin(), 'b');
+            }
+        }
+        assert((capacities == std::vector<size_t>{ 16, 24, 40, 64, 96, 160, 256 }));
+    }
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
+void Test11() {
+    using Alloc = StatefulAllocator<Obj, false>;
+    using SmallObjVector = SmallVector<Obj, 4, Alloc>;
+    const int ID = 42;
+    // Перемещающее присваивание и обмен с неравными аллокаторами могут выделять память
+    static_assert(!std::is_nothrow_move_assignable_v<SmallObjVector>);
+    static_assert(!noexcept(std::declval<SmallObjVector&>().Swap(std::declval<SmallObjVector&>())));
+    static_assert(std::is_nothrow_move_assignable_v<SmallVector<Obj, 4>>);
+    static_assert(noexcept(std::declval<SmallVector<Obj, 4>&>().Swap(std::declval<SmallVector<Obj, 4>&>())));
+    {
+        Obj::ResetCounters();
+        AllocStats stats;
         {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+            SmallObjVector v{ Alloc(&stats) };
+            assert(v.Capacity() == 4);
+            v.EmplaceBack(0);
+            v.EmplaceBack(ID);
+            v.EmplaceBack(3);
+            v.Erase(v.cbegin() + 1);
+            v.Emplace(v.cbegin() + 1, 2);
+            v.Insert(v.cbegin() + 1, Obj{ 1 });
+            assert(v.IsInline());
+            assert(stats.num_allocations == 0);
+
+            v.EmplaceBack(ID);
+            assert(!v.IsInline());
+            assert(v.Capacity() == 8);
+            assert(v.Size() == 5);
+            assert(v[0].id == 0 && v[3].id == 3 && v[4].id == ID);
+            assert(stats.num_allocations == 1);
+            assert(Obj::num_moved == 4 + 3);
+
+            v.Resize(2);
+            v.Resize(6);
+            assert(v.Size() == 6);
+            assert(v[1].id == 1 && v[5].id == 0);
+            assert(Obj::GetAliveObjectCount() == 6);
         }
-        Dump();
+        assert(stats.num_allocations == stats.num_deallocations);
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    catch (...) {
+    {
+        Obj::ResetCounters();
+        AllocStats stats;
+        {
+            SmallObjVector inline_v(3, Alloc(&stats));
+            inline_v[0].id = 1;
+            SmallObjVector heap_v(10, Alloc(&stats));
+            heap_v[0].id = 2;
+            const Obj* heap_data = &heap_v[0];
+
+            // Перемещение из динамической памяти забирает её целиком
+            SmallObjVector moved_heap(std::move(heap_v));
+            assert(&moved_heap[0] == heap_data);
+            assert(heap_v.Size() == 0 && heap_v.IsInline());
+            // Перемещение встроенного буфера перемещает элементы
+            SmallObjVector moved_inline(std::move(inline_v));
+            assert(moved_inline.IsInline() && moved_inline.Size() == 3 && moved_inline[0].id == 1);
+            assert(inline_v.Size() == 0);
+
+            moved_inline.Swap(moved_heap);
+            assert(moved_inline.Size() == 10 && &moved_inline[0] == heap_data);
+            assert(moved_heap.IsInline() && moved_heap.Size() == 3 && moved_heap[0].id == 1);
+
+            SmallObjVector copy(moved_inline);
+            assert(copy.Size() == 10 && copy[0].id == 2);
+            copy = moved_heap;
+            assert(copy.Size() == 3 && copy[0].id == 1 && !copy.IsInline());
+            moved_heap = moved_inline;
+            assert(moved_heap.Size() == 10 && moved_heap[0].id == 2);
+            assert(Obj::GetAliveObjectCount() == 23);
+        }
+        assert(stats.num_allocations == stats.num_deallocations);
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    try {
-        const size_t NUM = 10;
-        C c;
+    {
+        SmallVector<std::string, 2> v;
+        v.PushBack("a");
+        v.PushBack("b");
+        v.Insert(v.cbegin(), "c");
+        v.PopBack();
+        assert(v.Size() == 2 && v[0] == "c" && v[1] == "a");
+        SmallVector<std::string, 2> w;
+        w.PushBack("d");
+        v.Swap(w);
+        assert(v.Size() == 1 && v[0] == "d" && w.Size() == 2 && w[1] == "a");
+    }
+}
+
+void Test12() {
+    {
+        Vector<int> v{ 1, 2, 3 };
+        assert(v.Size() == 3 && v.Capacity() == 3);
+        const std::vector<int> src{ 10, 11, 12, 13 };
+        auto pos = v.Insert(v.cbegin() + 1, src.begin(), src.end());
+        assert(pos == v.begin() + 1);
+        assert(v.Capacity() == 7);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{ 1, 10, 11, 12, 13, 2, 3 }));
+        v.Reserve(20);
+        v.Insert(v.cbegin(), { 7, 8 });
+        v.Insert(v.cbegin() + 3, 3, v[0]);
+        v.Append(src.begin(), src.begin() + 2);
+        assert((std::vector<int>(v.begin(), v.end())
+                == std::vector<int>{ 7, 8, 1, 7, 7, 7, 10, 11, 12, 13, 2, 3, 10, 11 }));
+        assert(v.Capacity() == 20);
+
+        // Размер, превышающий MaxSize(), отвергается до выделения памяти
+        assert(v.MaxSize() == size_t(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(int));
+        try {
+            v.Insert(v.cbegin(), v.MaxSize() - v.Size() + 1, 0);
+            assert(false && "Exception is expected");
+        }
+        catch (const std::length_error&) {
+        }
+        assert(v.Size() == 14 && v.Capacity() == 20);
+    }
+    {
+        // Диапазон прямых итераторов: одно выделение памяти, без лишних копий
+        Obj::ResetCounters();
+        AllocStats stats;
         {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+            using Alloc = StatefulAllocator<Obj, false>;
+            Vector<Obj, Alloc> v(5, Alloc(&stats));
+            std::vector<Obj> src(10);
+            v.Insert(v.cbegin() + 2, src.begin(), src.end());
+            assert(v.Size() == 15);
+            assert(stats.num_allocations == 2);
+            assert(Obj::num_copied == 10);
+            assert(Obj::num_moved == 5);
+
+            v.Reserve(40);
+            v.Insert(v.cbegin() + 10, 3, Obj{ 7 });
+            assert(v.Size() == 18);
+            assert(v[10].id == 7 && v[12].id == 7 && v[13].id == 0);
+            assert(Obj::num_copied == 13);
+            assert(stats.num_allocations == 3);
         }
-        Dump();
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    catch (...) {
+    {
+        // Диапазон итераторов ввода
+        std::istringstream input("4 5 6");
+        Vector<std::string> v{ "a", "b" };
+        v.Insert(v.cbegin() + 1, std::istream_iterator<std::string>(input), std::istream_iterator<std::string>());
+        assert(v.Size() == 5 && v[0] == "a" && v[1] == "4" && v[3] == "6" && v[4] == "b");
+        v.Insert(v.cbegin(), 2, v[4]);
+        assert(v.Size() == 7 && v[0] == "b" && v[1] == "b" && v[6] == "b");
+        std::istringstream empty("");
+        const Vector<std::string> copy(std::istream_iterator<std::string>(empty), std::istream_iterator<std::string>{});
+        assert(copy.Size() == 0);
+    }
+    {
+        // Исключение при копировании вставляемого диапазона не изменяет вектор
+        Obj::ResetCounters();
+        Vector<Obj> v(4);
+        v.Reserve(10);
+        Vector<Obj> src(3);
+        src[1].throw_on_copy = true;
+        try {
+            v.Insert(v.cbegin() + 1, src.begin(), src.end());
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4);
+        assert(Obj::GetAliveObjectCount() == 7);
+    }
+    {
+        // Исключение при перестановке вставленных элементов на место разрушает их
+        {
+            Vector<ThrowingMoveAssign> v(4);
+            v.Reserve(10);
+            const ThrowingMoveAssign value(7);
+            ThrowingMoveAssign::move_assign_throw_countdown = 2;
+            try {
+                v.Insert(v.cbegin() + 1, 2, value);
+                assert(false && "Exception is expected");
+            }
+            catch (const std::runtime_error&) {
+            }
+            ThrowingMoveAssign::move_assign_throw_countdown = 0;
+            assert(v.Size() == 4 && ThrowingMoveAssign::alive == 5);
+        }
+        assert(ThrowingMoveAssign::alive == 0);
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, DEFAULT_INIT);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(Obj::num_default_constructed == SIZE);
+        v.ResizeDefaultInit(SIZE / 2);
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(v.Size() == SIZE * 2 && v.Capacity() == SIZE * 2);
+        assert(Obj::GetAliveObjectCount() == SIZE * 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Заполнение буфера чтения: прочитано меньше, чем запрошено
+        const std::string input = "hello, world";
+        Vector<char> buffer(5, DEFAULT_INIT);
+        std::copy_n(input.begin(), 5, buffer.begin());
+        buffer.ResizeAndOverwrite(64, [&](char* data, size_t size) {
+            assert(size == 64);
+            return static_cast<size_t>(std::copy(input.begin() + 5, input.end(), data + 5) - data);
+        });
+        assert(buffer.Size() == input.size());
+        assert(std::string(buffer.begin(), buffer.end()) == input);
+        assert(buffer.Capacity() == 64);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        try {
+            v.ResizeAndOverwrite(SIZE * 2, [](Obj*, size_t) -> size_t {
+                throw std::runtime_error("Oops");
+            });
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+        v.ResizeAndOverwrite(SIZE / 2, [](Obj* data, size_t size) {
+            data[0].id = 1;
+            return size - 1;
+        });
+        assert(v.Size() == SIZE / 2 - 1 && v[0].id == 1);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2 - 1);
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        auto pos = v.Erase(v.cbegin() + 2, v.cbegin() + 5);
+        assert(pos == v.begin() + 2 && pos->id == 5);
+        assert(v.Size() == SIZE - 3 && v.Capacity() == SIZE);
+        assert(Obj::num_move_assigned == SIZE - 5);
+        assert(Obj::GetAliveObjectCount() == SIZE - 3);
+        assert(v.Erase(v.cbegin() + 1, v.cbegin() + 1) == v.begin() + 1);
+
+        Obj::ResetCounters();
+        pos = v.SwapErase(v.cbegin() + 1);
+        assert(pos->id == static_cast<int>(SIZE - 1));
+        assert(v.Size() == SIZE - 4);
+        assert(Obj::num_move_assigned == 1 && Obj::num_destroyed == 1);
+        v.SwapErase(v.cend() - 1);
+        assert(v.Size() == SIZE - 5 && v[v.Size() - 1].id == 7);
+
+        // Остались 0, 9, 5, 6, 7
+        assert(v.EraseIf([](const Obj& obj) { return obj.id % 2 != 0; }) == 3);
+        assert(v.Size() == 2 && v[0].id == 0 && v[1].id == 6);
+        assert(Obj::num_destroyed == 5);
+    }
+    {
+        RelocObj::ResetCounters();
+        Vector<RelocObj> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Erase(v.cbegin(), v.cbegin() + 2);
+        assert(v.Size() == SIZE - 2 && v[0].id == 2);
+        v.SwapErase(v.cbegin());
+        assert(v[0].id == static_cast<int>(SIZE - 1));
+        assert(v.EraseIf([](const RelocObj& obj) { return obj.id < 5; }) == 2);
+        assert(v.Size() == 5 && v[0].id == 9 && v[1].id == 5 && v[4].id == 8);
+        assert(RelocObj::num_moved == 0);
+        assert(RelocObj::num_destroyed == 5);
+
+        // Исключение в предикате оставляет вектор целостным
+        try {
+            v.EraseIf([](const RelocObj& obj) {
+                if (obj.id == 6) {
+                    throw std::runtime_error("Oops");
+                }
+                return obj.id == 9;
+            });
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4 && v[0].id == 5 && v[1].id == 6 && v[3].id == 8);
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 4);
+        v.Resize(SIZE / 2);
+        v.ShrinkToFit();
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE / 2);
+        assert(Obj::num_moved == SIZE + SIZE / 2);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 2);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == 0);
+        v.PushBack(Obj{ 1 });
+        v.ClearAndRelease();
+        assert(v.Size() == 0 && v.Capacity() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Vector<int, ReallocAllocator<int>> v(SIZE);
+        v[SIZE / 4 - 1] = 42;
+        v.Resize(SIZE / 4);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 4 && v[SIZE / 4 - 1] == 42);
+    }
+    {
+        // Автоматическое уменьшение ёмкости с гистерезисом
+        using Growth = HysteresisShrink<DoublingGrowth, 4, 64>;
+        Vector<int, std::allocator<int>, Growth> v(SIZE * 10);
+        v.Erase(v.cbegin() + SIZE * 3, v.cend());
+        assert(v.Capacity() == SIZE * 10);
+        v.Erase(v.cbegin() + SIZE * 2, v.cend());
+        assert(v.Size() == SIZE * 2 && v.Capacity() == SIZE * 4);
+        while (v.Size() > SIZE + 1) {
+            v.PopBack();
+        }
+        assert(v.Capacity() == SIZE * 4);
+        v.PopBack();
+        assert(v.Size() == SIZE && v.Capacity() == SIZE * 2);
+        v.Resize(4);
+        // Блок в 64 байта и меньше не уменьшается
+        assert(v.Capacity() == 8);
+        v.Resize(0);
+        assert(v.Capacity() == 8);
+        v.PushBack(1);
+        assert(v.Capacity() == 8);
+    }
+}
+
+struct Test16Tag {
+    static constexpr std::string_view NAME = "test16";
+};
+
+struct Test16CopyTag {
+    static constexpr std::string_view NAME = "test16_copy";
+};
+
+void Test16() {
+    // Без политики статистики вектор не хранит ничего лишнего
+    static_assert(sizeof(Vector<int>) == sizeof(int*) + 2 * sizeof(size_t));
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        Vector<Obj, std::allocator<Obj>, DoublingGrowth, VectorStats<Test16Tag>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.Erase(v.cbegin());
+        v.Insert(v.cbegin() + 5, Obj{ 1 });
+        v.Reserve(SIZE * 4);
+    }
+    {
+        struct CopyOnly {
+            CopyOnly() = default;
+            CopyOnly(const CopyOnly&) {
+            }
+        };
+        Vector<CopyOnly, std::allocator<CopyOnly>, DoublingGrowth, VectorStats<Test16CopyTag>> v(SIZE);
+        v.Reserve(SIZE * 2);
+    }
+    const auto snapshot = VectorStatsRegistry::Instance().Snapshot();
+    const auto find = [&](std::string_view name) {
+        return *std::find_if(snapshot.begin(), snapshot.end(), [&](const VectorStatsSnapshot& s) {
+            return s.name == name;
+        });
+    };
+    const VectorStatsSnapshot stats = find("test16");
+    // Ёмкости 1, 2, 4, 8, 16 и затем Reserve до 40
+    assert(stats.allocations == 6 && stats.deallocations == 6);
+    assert(stats.bytes_allocated == (1 + 2 + 4 + 8 + 16 + 40) * sizeof(Obj));
+    assert(stats.reallocations == 6);
+    assert(stats.relocated_by_move == 1 + 2 + 4 + 8 + SIZE);
+    assert(stats.relocated_by_copy == 0 && stats.relocated_bitwise == 0);
+    assert(stats.shifted == (SIZE - 1) + (SIZE - 1 - 5));
+    assert(stats.peak_size == SIZE && stats.peak_capacity == SIZE * 4);
+
+    const VectorStatsSnapshot copy_stats = find("test16_copy");
+    assert(copy_stats.relocated_by_copy == SIZE && copy_stats.relocated_by_move == 0);
+    assert(copy_stats.peak_size == SIZE && copy_stats.peak_capacity == SIZE * 2);
+
+    VectorStatsRegistry::Instance().Reset();
+    assert(VectorStatsRegistry::Instance().Snapshot().front().allocations == 0);
+}
+
+void Test17() {
+    using namespace std::literals;
+    CheckSimdAlgorithms<int8_t>();
+    CheckSimdAlgorithms<uint8_t>();
+    CheckSimdAlgorithms<int16_t>();
+    CheckSimdAlgorithms<uint16_t>();
+    CheckSimdAlgorithms<int>();
+    CheckSimdAlgorithms<uint32_t>();
+    CheckSimdAlgorithms<int64_t>();
+    CheckSimdAlgorithms<uint64_t>();
+    CheckSimdAlgorithms<float>();
+    CheckSimdAlgorithms<double>();
+    {
+        // Значения с плавающей точкой сравниваются по ==, а не побайтово
+        Vector<double> v(100);
+        v[10] = -0.0;
+        v[20] = std::numeric_limits<double>::quiet_NaN();
+        assert(Find(v, 0.0) == v.begin());
+        Fill(v, 1.0);
+        v[10] = -0.0;
+        assert(Find(v, 0.0) == v.begin() + 10);
+        assert(Count(v, std::numeric_limits<double>::quiet_NaN()) == 0);
+    }
+    {
+        // Значение другого типа сравнивается с элементами, как в std::find, без сужения к их типу
+        Vector<uint8_t> bytes(100);
+        Fill(bytes, 300);
+        assert(Count(bytes, 44) == 100);
+        bytes[50] = 255;
+        assert(Find(bytes, 300) == bytes.end() && Count(bytes, 300) == 0);
+        assert(Find(bytes, -1) == bytes.end() && Count(bytes, -1) == 0);
+        assert(Find(bytes, 255u) == bytes.begin() + 50 && Count(bytes, 255) == 1);
+
+        Vector<int8_t> chars(100);
+        Fill(chars, -56);
+        assert(Count(chars, uint8_t{ 200 }) == static_cast<size_t>(std::count(chars.begin(), chars.end(), uint8_t{ 200 })));
+        assert(Count(chars, int64_t{ -56 }) == 100);
+
+        Vector<uint32_t> words(100);
+        Fill(words, std::numeric_limits<uint32_t>::max());
+        assert(Count(words, -1) == static_cast<size_t>(std::count(words.begin(), words.end(), -1)));
+        assert(Count(words, int64_t{ -1 }) == 0);
+
+        Vector<float> floats(100);
+        Fill(floats, 0.5);
+        assert(Count(floats, 0.5) == 100 && Find(floats, 0.1) == floats.end());
+        floats[7] = 0.1f;
+        assert(Find(floats, 0.1) == std::find(floats.begin(), floats.end(), 0.1));
+        assert(Find(floats, 0.1f) == floats.begin() + 7);
+    }
+    {
+        // Для прочих типов алгоритмы сводятся к std::
+        Vector<std::string> v(5);
+        Fill(v, "a"s);
+        v[3] = "b"s;
+        assert(Find(v, "b"s) == v.begin() + 3);
+        assert(Count(v, "a"s) == 4);
+        assert(MaxElement(v) == v.begin() + 3);
+    }
+    {
+        Vector<uint8_t> a{ 1, 2, 3 };
+        Vector<uint8_t> b{ 1, 2, 3, 0 };
+        Vector<uint8_t> c{ 1, 200 };
+        assert(a == a && a != b && a < b && b < c && !(c < a) && c > a && a <= a && a >= a);
+        assert(Vector<uint8_t>{} < a && Vector<uint8_t>{} == Vector<uint8_t>{});
+
+        Vector<int> x{ 1, -2, 3 };
+        Vector<int> y{ 1, 2 };
+        assert(x != y && x < y && y > x && x == Vector<int>({ 1, -2, 3 }));
+
+        Vector<std::string> s1{ "a"s, "b"s };
+        Vector<std::string> s2{ "a"s, "c"s };
+        assert(s1 != s2 && s1 < s2 && s1 == s1);
+    }
+}
+
+void Test18() {
+    const auto is_aligned = [](const void* p, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+    };
+    {
+        // Тип с повышенным выравниванием и стандартный аллокатор
+        struct alignas(128) Wide {
+            int value = 0;
+        };
+        Vector<Wide> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(Wide{ i });
+            assert(is_aligned(v.begin(), alignof(Wide)));
+        }
+        assert(v[9].value == 9);
+    }
+    {
+        static_assert(AlignedAllocator<char, 64>::ALIGNMENT == 64);
+        static_assert(AlignedAllocator<double, 4>::ALIGNMENT == alignof(double));
+        AlignedVector<int> v;
+        v.PushBack(0);
+        assert(is_aligned(v.begin(), 64));
+        // Блок округлён до 64 байт, поэтому первые 16 элементов помещаются без перевыделения
+        const int* data = v.begin();
+        for (int i = 1; i < 16; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.begin() == data && v.Capacity() == 16);
+        v.PushBack(16);
+        assert(v.begin() != data && is_aligned(v.begin(), 64));
+        assert(v.Capacity() == 32 && v[16] == 16 && v[1] == 1);
+
+        AlignedVector<int, 256> copy(v.begin(), v.end());
+        assert(is_aligned(copy.begin(), 256) && copy.Size() == v.Size());
+        v.ShrinkToFit();
+        assert(is_aligned(v.begin(), 64) && v.Capacity() == v.Size());
+    }
+}
+
+struct Test19Tag {
+    static constexpr std::string_view NAME = "test19";
+};
+
+void Test19() {
+    using Alloc = MmapAllocator<uint64_t>;
+    const size_t MAPPED_SIZE = Alloc::THRESHOLD / sizeof(uint64_t);
+    static_assert(!Alloc::IsMapped(1000));
+    {
+        HugePageVector<uint64_t> v;
+        for (uint64_t i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v[999] == 999);
+    }
+#if defined(VECTOR_HAS_MMAP)
+    static_assert(Alloc::IsMapped(MAPPED_SIZE));
+    VectorStatsRegistry::Instance().Reset();
+    {
+        Vector<uint64_t, Alloc, DoublingGrowth, VectorStats<Test19Tag>> v;
+        v.Reserve(MAPPED_SIZE);
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % Alloc::HUGE_PAGE_SIZE == 0);
+        for (uint64_t i = 0; i < MAPPED_SIZE; ++i) {
+            v.PushBack(i * 3);
+        }
+        // Рост отображённого блока не переносит элементы поштучно
+        v.Reserve(MAPPED_SIZE * 4);
+        v.PushBack(1);
+        assert(v.Capacity() >= MAPPED_SIZE * 4 && v.Size() == MAPPED_SIZE + 1);
+        assert(v[0] == 0 && v[MAPPED_SIZE - 1] == (MAPPED_SIZE - 1) * 3 && v[MAPPED_SIZE] == 1);
+
+        // Уменьшение ниже порога возвращает блок в обычную кучу
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10 && v[9] == 27);
+    }
+    const auto snapshot = VectorStatsRegistry::Instance().Snapshot();
+    const VectorStatsSnapshot stats = *std::find_if(snapshot.begin(), snapshot.end(), [](const VectorStatsSnapshot& s) {
+        return s.name == "test19";
+    });
+    assert(stats.allocations == 1 && stats.deallocations == 1);
+    assert(stats.relocated_by_move == 0 && stats.relocated_by_copy == 0);
+#endif
+}
+
+void Test20() {
+#if defined(VECTOR_HAS_MMAP)
+    struct Record {
+        uint64_t key;
+        double value;
+    };
+    const size_t SIZE = 100'000;
+    const std::string path = (std::filesystem::temp_directory_path() / "advanced_vector_test20.bin").string();
+    std::filesystem::remove(path);
+    {
+        MappedVector<Record> v(path, MappedVectorMode::READ_WRITE, 3);
+        assert(v.Size() == 0 && v.Capacity() > 0 && v.DataVersion() == 3);
+        for (uint64_t i = 0; i < SIZE; ++i) {
+            v.PushBack(Record{ i, i * 0.5 });
+        }
+        assert(v.Size() == SIZE && v[SIZE - 1].key == SIZE - 1);
+        v.Flush();
+    }
+    {
+        const MappedVector<Record> v(path, MappedVectorMode::READ_ONLY, 3);
+        assert(!v.IsWritable() && v.Size() == SIZE);
+        assert(v[12345].key == 12345 && v[12345].value == 12345 * 0.5);
+        uint64_t sum = 0;
+        for (const Record& r : v) {
+            sum += r.key;
+        }
+        assert(sum == SIZE * (SIZE - 1) / 2);
+    }
+    {
+        // Дописывание в существующий файл
+        MappedVector<Record> v(path, MappedVectorMode::READ_WRITE, 3);
+        Vector<Record> tail{ Record{ 1, 1.0 }, Record{ 2, 2.0 } };
+        v.Append(tail.begin(), tail.end());
+        v.PopBack();
+        assert(v.Size() == SIZE + 1 && v[SIZE].key == 1);
+        v.Resize(SIZE + 3);
+        assert(v[SIZE + 1].key == 0 && v[SIZE + 2].value == 0.0);
+
+        MappedVector<Record> moved(std::move(v));
+        assert(moved.Size() == SIZE + 3);
+    }
+    const auto expect_error = [](auto open) {
+        try {
+            open();
+            assert(false);
+        }
+        catch (const std::runtime_error&) {
+        }
+    };
+    // Другой тип элементов, другая версия данных и отсутствующий файл
+    expect_error([&] {
+        MappedVector<uint32_t> v(path, MappedVectorMode::READ_ONLY, 3);
+    });
+    expect_error([&] {
+        MappedVector<Record> v(path, MappedVectorMode::READ_ONLY, 4);
+    });
+    expect_error([&] {
+        MappedVector<Record> v(path + ".missing", MappedVectorMode::READ_ONLY);
+    });
+    assert(MappedVector<Record>(path, MappedVectorMode::READ_ONLY, 3).Size() == SIZE + 3);
+    std::filesystem::remove(path);
+#endif
+}
+
+void Test21() {
+    using namespace std::literals;
+    {
+        Vector<uint32_t> v;
+        for (uint32_t i = 0; i < 1000; ++i) {
+            v.PushBack(i * 7);
+        }
+        std::stringstream stream;
+        WriteTo(v, stream);
+        WriteTo(Vector<uint32_t>{}, stream);
+        assert(stream.str().size() == 2 * sizeof(VectorStreamHeader) + v.Size() * sizeof(uint32_t));
+
+        Vector<uint32_t> read{ 1, 2, 3 };
+        ReadFrom(read, stream);
+        assert(read == v);
+        ReadFrom(read, stream);
+        assert(read.Size() == 0);
+    }
+    {
+        // Нетривиальные типы пишутся через VectorCodec
+        Vector<std::string> v{ "hello"s, ""s, std::string(100'000, 'x') };
+        std::stringstream stream;
+        WriteTo(v, stream);
+        Vector<std::string> read;
+        ReadFrom(read, stream);
+        assert(read == v);
+
+        Vector<Obj> objs;
+        objs.EmplaceBack(1, "one"s);
+        objs.EmplaceBack(2, "two"s);
+        std::stringstream obj_stream;
+        WriteTo(objs, obj_stream);
+        Vector<Obj> read_objs;
+        ReadFrom(read_objs, obj_stream);
+        assert(read_objs.Size() == 2 && read_objs[0].id == 1 && read_objs[1].id == 2);
+    }
+    const auto expect_error = [](auto read) {
+        try {
+            read();
+            assert(false);
+        }
+        catch (const std::runtime_error&) {
+        }
+    };
+    {
+        Vector<uint64_t> v(100);
+        std::stringstream stream;
+        WriteTo(v, stream);
+        const std::string data = stream.str();
+        Vector<uint64_t> read{ 42 };
+        // Обрезанные данные, другой тип элементов и мусор вместо заголовка
+        expect_error([&] {
+            std::stringstream truncated(data.substr(0, data.size() - 1));
+            ReadFrom(read, truncated);
+        });
+        expect_error([&] {
+            std::stringstream in(data);
+            Vector<uint32_t> other;
+            ReadFrom(other, in);
+        });
+        expect_error([&] {
+            std::stringstream in("garbage, not a vector"s);
+            ReadFrom(read, in);
+        });
+        // При ошибке содержимое не меняется
+        assert(read.Size() == 1 && read[0] == 42);
+    }
+#if defined(VECTOR_HAS_FD_IO)
+    {
+        const std::string path = (std::filesystem::temp_directory_path() / "advanced_vector_test21.bin").string();
+        Vector<double> v;
+        for (int i = 0; i < 1'000'000; ++i) {
+            v.PushBack(i * 0.25);
+        }
+        const int out = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        assert(out >= 0);
+        WriteTo(v, out);
+        ::close(out);
+
+        const int in = ::open(path.c_str(), O_RDONLY);
+        assert(in >= 0);
+        Vector<double> read;
+        ReadFrom(read, in);
+        ::close(in);
+        assert(read == v);
+        std::filesystem::remove(path);
+    }
+#endif
+}
+
+void Test22() {
+    using namespace std::literals;
+    {
+        // Потоки добавляют элементы одновременно, адреса уже добавленных элементов не меняются
+        const int THREADS = 8;
+        const int PER_THREAD = 20'000;
+        ConcurrentVector<uint64_t> v;
+        std::vector<std::vector<const uint64_t*>> addresses(THREADS);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&v, &addresses, t] {
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    addresses[t].push_back(&v.EmplaceBack(uint64_t(t) * PER_THREAD + i));
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        assert(v.Size() == size_t(THREADS * PER_THREAD));
+        for (int t = 0; t < THREADS; ++t) {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                assert(*addresses[t][i] == uint64_t(t) * PER_THREAD + i);
+            }
+        }
+        std::vector<bool> seen(THREADS * PER_THREAD);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(!seen[v[i]]);
+            seen[v[i]] = true;
+        }
+
+        Vector<uint64_t> frozen = v.Freeze();
+        assert(frozen.Size() == size_t(THREADS * PER_THREAD) && v.Size() == 0);
+        std::sort(frozen.begin(), frozen.end());
+        for (size_t i = 0; i < frozen.Size(); ++i) {
+            assert(frozen[i] == i);
+        }
+    }
+    {
+        // Место, где конструктор выбросил исключение, пропускается
+        Obj::ResetCounters();
+        {
+            ConcurrentVector<Obj> v;
+            for (int i = 0; i < 100; ++i) {
+                v.EmplaceBack(i, "obj"s);
+            }
+            Obj::default_construction_throw_countdown = 1;
+            try {
+                v.EmplaceBack();
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            v.EmplaceBack(100);
+            assert(v.Size() == 102 && Obj::GetAliveObjectCount() == 101);
+
+            Vector<Obj> frozen = v.Freeze();
+            assert(frozen.Size() == 101 && frozen[99].id == 99 && frozen[100].id == 100);
+            assert(Obj::GetAliveObjectCount() == 101);
+            v.EmplaceBack(1);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Нехватка памяти под сегмент после резервирования места оставляет место пустым
+        using Alloc = FailingAllocator<Obj>;
+        const size_t FIRST = ConcurrentVector<Obj, Alloc>::FIRST_SEGMENT;
+        const auto fill_and_fail = [FIRST](ConcurrentVector<Obj, Alloc>& v) {
+            // Первое выделение - сегмент 0, второе - заблаговременное выделение сегмента 1,
+            // неудача которого не видна, третье - выделение сегмента 1 при добавлении в него
+            allocation_failure_countdown = 2;
+            for (size_t i = 0; i < FIRST; ++i) {
+                v.EmplaceBack(static_cast<int>(i));
+            }
+            allocation_failure_countdown = 1;
+            try {
+                v.EmplaceBack(-1);
+                assert(false);
+            }
+            catch (const std::bad_alloc&) {
+            }
+            allocation_failure_countdown = 0;
+            assert(v.Size() == FIRST + 1);
+        };
+        Obj::ResetCounters();
+        {
+            ConcurrentVector<Obj, Alloc> v;
+            fill_and_fail(v);
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(FIRST));
+            // Сегмент, все места которого пусты, не выделен, и Freeze его пропускает
+            auto frozen = v.Freeze();
+            assert(frozen.Size() == FIRST && frozen[FIRST - 1].id == static_cast<int>(FIRST - 1));
+
+            // Пустое место в сегменте, выделенном следующим EmplaceBack, пропускается
+            fill_and_fail(v);
+            v.EmplaceBack(-2);
+            assert(v.Size() == FIRST + 2 && v[FIRST + 1].id == -2);
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(2 * FIRST + 1));
+            frozen = v.Freeze();
+            assert(frozen.Size() == FIRST + 1 && frozen[FIRST].id == -2);
+
+            fill_and_fail(v);
+            v.EmplaceBack(-3);
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(2 * FIRST + 2));
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test23() {
+    using namespace std::literals;
+    ThreadPool pool(4);
+    const ParallelPolicy policy{ &pool };
+    const size_t SIZE = 300'000;
+    {
+        Vector<int> zeros(SIZE, policy);
+        assert(zeros.Size() == SIZE && Count(zeros, 0) == SIZE);
+
+        Vector<uint64_t> squares(SIZE, [](size_t i) { return uint64_t(i) * i; }, policy);
+        assert(squares.Size() == SIZE && squares[SIZE - 1] == uint64_t(SIZE - 1) * (SIZE - 1));
+        squares.Resize(2 * SIZE, policy);
+        assert(squares.Size() == 2 * SIZE && squares[SIZE - 1] != 0 && squares[2 * SIZE - 1] == 0);
+        squares.Resize(10, policy);
+        assert(squares.Size() == 10 && squares[3] == 9);
+    }
+    {
+        Vector<uint64_t> v(SIZE, [](size_t i) { return uint64_t(i); }, policy);
+        ParallelForEach(v, [](uint64_t& x) { x *= 2; }, policy);
+        assert(ParallelReduce(v, uint64_t(0), std::plus<>(), policy) == uint64_t(SIZE) * (SIZE - 1));
+
+        // Операция ассоциативна, но не коммутативна: порядок частей сохраняется
+        Vector<std::string> digits(SIZE, [](size_t i) { return std::string(1, char('0' + i % 10)); }, policy);
+        const std::string joined = ParallelReduce(digits, ""s, std::plus<>(), policy);
+        assert(joined.size() == SIZE && joined.compare(0, 12, "012345678901") == 0 && joined.back() == '9');
+
+        Vector<double> halves = ParallelTransform(v, [](uint64_t x) { return x / 4.0; }, policy);
+        assert(halves.Size() == SIZE && halves[SIZE - 1] == (SIZE - 1) / 2.0);
+    }
+    {
+        std::mt19937 generator(42);
+        Vector<uint32_t> v(SIZE, DEFAULT_INIT);
+        for (uint32_t& x : v) {
+            x = generator();
+        }
+        std::vector<uint32_t> expected(v.begin(), v.end());
+        std::sort(expected.begin(), expected.end(), std::greater<>());
+        ParallelSort(v, std::greater<>(), policy);
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    }
+    {
+        // Вложенный вызов выполняется последовательно и не блокирует пул
+        Vector<Vector<int>> nested(64, [](size_t) { return Vector<int>(10'000); }, policy);
+        ParallelForEach(nested, [&policy](Vector<int>& inner) {
+            ParallelForEach(inner, [](int& x) { ++x; }, policy);
+        }, policy);
+        for (const Vector<int>& inner : nested) {
+            assert(Count(inner, 1) == inner.Size());
+        }
+    }
+    {
+        // При исключении уже созданные элементы разрушаются
+        try {
+            Vector<std::string> v(SIZE, [](size_t i) {
+                if (i == SIZE / 3) {
+                    throw std::runtime_error("Oops");
+                }
+                return std::string(32, 'x');
+            }, policy);
+            assert(false);
+        }
+        catch (const std::runtime_error&) {
+        }
+    }
+}
+
+void Test24() {
+    using namespace std::literals;
+    {
+        // x, y, масса, имя
+        SoAVector<double, double, int, std::string> particles;
+        for (int i = 0; i < 1000; ++i) {
+            particles.EmplaceBack(i * 1.0, i * 2.0, i % 7, "p"s + std::to_string(i));
+        }
+        assert(particles.Size() == 1000 && particles.Capacity() >= 1000);
+        auto [x, y, mass, name] = particles[10];
+        assert(x == 10.0 && y == 20.0 && mass == 3 && name == "p10");
+        x = -1.0;
+        assert(particles.Get<0>(10) == -1.0);
+
+        // Столбец лежит подряд
+        const SoAColumn<double> ys = particles.Column<1>();
+        assert(ys.Size() == 1000 && &ys[1] == &ys[0] + 1);
+        double sum = 0;
+        for (double value : ys) {
+            sum += value;
+        }
+        assert(sum == 999.0 * 1000.0);
+
+        // Прокси-итератор по строкам совместим с алгоритмами
+        auto heavy = std::find_if(particles.begin(), particles.end(), [](const auto& row) {
+            return std::get<2>(row) == 6;
+        });
+        assert(heavy.Index() == 6 && std::get<3>(*heavy) == "p6");
+        assert(std::count_if(particles.cbegin(), particles.cend(), [](const auto& row) {
+                   return std::get<2>(row) == 0;
+               }) == 143);
+
+        particles.Erase(particles.begin() + 1, particles.begin() + 11);
+        assert(particles.Size() == 990 && particles.Get<3>(1) == "p11" && particles.Get<1>(1) == 22.0);
+        particles.PopBack();
+        assert(particles.Size() == 989 && particles.Get<3>(988) == "p998");
+
+        SoAVector<double, double, int, std::string> copy = particles;
+        particles.Resize(2000);
+        assert(particles.Size() == 2000 && particles.Get<0>(1999) == 0.0 && particles.Get<3>(1999).empty());
+        assert(copy.Size() == 989 && copy.Get<3>(988) == "p998");
+        copy.Swap(particles);
+        assert(copy.Size() == 2000 && particles.Size() == 989);
+
+        // Аргумент может ссылаться на элемент вектора, который переносится при росте
+        SoAVector<std::string> strings;
+        strings.EmplaceBack("first"s);
+        strings.EmplaceBack(strings.Get<0>(0));
+        strings.PushBack(std::tuple("third"s));
+        assert(strings.Size() == 3 && strings.Get<0>(1) == "first" && strings.Get<0>(2) == "third");
+    }
+    {
+        // Исключение при копировании одного из полей оставляет вектор без изменений
+        Obj::ResetCounters();
+        {
+            SoAVector<std::string, Obj> v;
+            v.Reserve(2);
+            v.EmplaceBack("a"s, 1);
+            v.EmplaceBack("b"s, 2);
+            Obj throwing(3);
+            throwing.throw_on_copy = true;
+            try {
+                v.EmplaceBack("c"s, throwing);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2 && v.Capacity() == 2 && v.Get<0>(1) == "b" && v.Get<1>(1).id == 2);
+            Obj::default_construction_throw_countdown = 3;
+            try {
+                v.Resize(10);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2 && Obj::GetAliveObjectCount() == 3);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Исключение при сдвиге последнего столбца не разрушает освобождённые места
+        // остальных столбцов: размер и число живых объектов не меняются
+        Obj::ResetCounters();
+        {
+            SoAVector<std::unique_ptr<int>, Obj, ThrowingMoveAssign> v;
+            for (int i = 0; i < 5; ++i) {
+                v.EmplaceBack(std::make_unique<int>(i), Obj(i), ThrowingMoveAssign(i));
+            }
+            ThrowingMoveAssign::move_assign_throw_countdown = 2;
+            try {
+                v.Erase(v.begin() + 1);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 5 && Obj::GetAliveObjectCount() == 5 && ThrowingMoveAssign::alive == 5);
+            assert(*v.Get<0>(1) == 1 && *v.Get<0>(4) == 4);
+
+            v.Erase(v.begin() + 1);
+            assert(v.Size() == 4 && *v.Get<0>(1) == 2 && v.Get<2>(3).value == 4);
+            assert(Obj::GetAliveObjectCount() == 4 && ThrowingMoveAssign::alive == 4);
+        }
+        assert(Obj::GetAliveObjectCount() == 0 && ThrowingMoveAssign::alive == 0);
+    }
+    {
+        // Поле без копирования с бросающим перемещением переносится до остальных полей:
+        // исключение не вызывает terminate, а все объекты остаются живыми
+        Obj::ResetCounters();
+        {
+            SoAVector<Obj, ThrowingMoveOnly> v;
+            v.Reserve(4);
+            for (int i = 0; i < 4; ++i) {
+                v.EmplaceBack(Obj(i), ThrowingMoveOnly(i));
+            }
+            ThrowingMoveOnly::move_throw_countdown = 3;
+            try {
+                v.EmplaceBack(Obj(4), ThrowingMoveOnly(4));
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 4 && v.Capacity() == 4);
+            assert(Obj::GetAliveObjectCount() == 4 && ThrowingMoveOnly::alive == 4);
+            assert(v.Get<0>(3).id == 3 && v.Get<1>(3).value == 3);
+
+            v.EmplaceBack(Obj(4), ThrowingMoveOnly(4));
+            assert(v.Size() == 5 && v.Get<1>(4).value == 4 && ThrowingMoveOnly::alive == 5);
+        }
+        assert(Obj::GetAliveObjectCount() == 0 && ThrowingMoveOnly::alive == 0);
+    }
+    {
+        // Итератор строк удовлетворяет требованиям произвольного доступа, включая n + it
+        SoAVector<int> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        const auto it = 3 + v.begin();
+        assert(it == v.begin() + 3 && std::get<0>(*it) == 3);
+        assert(std::get<0>(*(2 + v.cbegin())) == 2 && (v.end() - 1) - v.begin() == 9);
+    }
+}
+
+struct Test25Tag {
+    static constexpr std::string_view NAME = "test25";
+};
+
+struct Test25StringTag {
+    static constexpr std::string_view NAME = "test25_string";
+};
+
+void Test25() {
+    using namespace std::literals;
+    {
+        // Рост в пределах ёмкости создаёт элементы после существующих
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(10);
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        v.Resize(5);
+        assert(v.Size() == 5 && v.Capacity() == 10);
+        assert(v[0].id == 1 && v[1].id == 2 && v[4].id == 0);
+        assert(Obj::num_default_constructed == 3 && Obj::GetAliveObjectCount() == 5);
+        // Рост с реаллокацией сохраняет старые элементы
+        v.Resize(20);
+        assert(v[0].id == 1 && v[1].id == 2 && Obj::GetAliveObjectCount() == 20);
+        v.Resize(1);
+        assert(v.Size() == 1 && v[0].id == 1 && Obj::GetAliveObjectCount() == 1);
+    }
+    {
+        // Копирование не трогает источник, даже если T перемещается без исключений
+        Vector<std::string> source{ std::string(100, 'a'), std::string(100, 'b') };
+        Vector<std::string> copy(source);
+        assert(copy == source && source[0] == std::string(100, 'a'));
+        Vector<std::string> shorter{ "x"s, "y"s, "z"s };
+        shorter = source;
+        assert(shorter == source);
+        Vector<std::string> longer{ "x"s };
+        longer.Reserve(4);
+        longer = source;
+        assert(longer == source && longer.Capacity() == 4);
+    }
+    {
+        using Stats = VectorStats<Test25Tag>;
+        Vector<uint64_t, std::allocator<uint64_t>, DoublingGrowth, Stats> v(100);
+        assert(Count(v.begin(), v.end(), uint64_t(0)) == 100);
+        v.Reserve(200);
+        v.Resize(150);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            v[i] = i;
+        }
+        Vector<uint64_t, std::allocator<uint64_t>, DoublingGrowth, Stats> copy(v);
+        Vector<uint64_t, std::allocator<uint64_t>, DoublingGrowth, Stats> assigned(10);
+        assigned.Reserve(200);
+        assigned = v;
+        assert(copy == v && assigned == v && assigned.Capacity() == 200);
+
+        Vector<std::string, std::allocator<std::string>, DoublingGrowth, VectorStats<Test25StringTag>> strings(3);
+        auto strings_copy = strings;
+        strings_copy = strings;
+
+        const auto snapshot = VectorStatsRegistry::Instance().Snapshot();
+        const auto find = [&](std::string_view name) {
+            return *std::find_if(snapshot.begin(), snapshot.end(), [&](const VectorStatsSnapshot& s) {
+                return s.name == name;
+            });
+        };
+        // Тривиальные типы копируются через memcpy и обнуляются через memset
+        const VectorStatsSnapshot stats = find("test25");
+        assert(stats.zero_filled == 100 + 50 + 10 && stats.value_initialized == 0);
+        assert(stats.copied_bitwise == 150 + 150 && stats.copied_by_element == 0);
+        const VectorStatsSnapshot string_stats = find("test25_string");
+        assert(string_stats.value_initialized == 3 && string_stats.zero_filled == 0);
+        assert(string_stats.copied_by_element == 3 + 3 && string_stats.copied_bitwise == 0);
+    }
+    {
+        // Нулевой указатель на член не состоит из нулевых байтов, поэтому memset не используется
+        struct S {
+            int x;
+        };
+        static_assert(IsZeroInitializableV<double> && IsZeroInitializableV<S*> && !IsZeroInitializableV<int S::*>);
+        Vector<int S::*> members(4);
+        assert(std::all_of(members.begin(), members.end(), [](int S::*p) { return p == nullptr; }));
+    }
+}
+
+void Test26() {
+    using namespace std::literals;
+    {
+        StableVector<int, std::allocator<int>, 16> v;
+        v.PushBack(42);
+        const int* first = &v[0];
+        const auto first_it = v.cbegin();
+        for (int i = 1; i < 10'000; ++i) {
+            v.PushBack(i);
+        }
+        // Рост не перемещает элементы и не инвалидирует итераторы
+        assert(&v[0] == first && *first_it == 42);
+        assert(v.Size() == 10'000 && v.Capacity() == 10'000);
+        assert(&v[17] == &v[16] + 1);
+
+        int* last = &v[v.Size() - 1];
+        v.PopBack();
+        v.EmplaceBack(v[1]);
+        assert(&v[v.Size() - 1] == last && *last == 1);
+
+        // Итераторы произвольного доступа работают с алгоритмами
+        v[0] = 0;
+        std::sort(v.begin(), v.end(), std::greater<>());
+        assert(v[0] == 9'998 && v[9'997] == 1 && v[9'998] == 1 && v[9'999] == 0);
+        assert(std::find(v.begin(), v.end(), 5'000) - v.begin() == 4'998);
+        assert(std::accumulate(v.cbegin(), v.cend(), 0LL) == 9'998LL * 9'999 / 2 + 1);
+        assert(std::is_sorted(std::make_reverse_iterator(v.end()), std::make_reverse_iterator(v.begin())));
+
+        v.Resize(20);
+        v.ShrinkToFit();
+        assert(v.Size() == 20 && v.Capacity() == 32);
+        v.Resize(40);
+        assert(v.Size() == 40 && v[19] == 9'979 && v[20] == 0 && v[39] == 0);
+    }
+    {
+        StableVector<std::string> strings{ "a"s, "b"s };
+        StableVector<std::string> copy = strings;
+        copy.PushBack(std::string(100, 'c'));
+        strings = copy;
+        assert(strings.Size() == 3 && strings[2] == copy[2]);
+        StableVector<std::string> moved = std::move(copy);
+        assert(moved.Size() == 3 && copy.Size() == 0);
+        strings.Swap(copy);
+        assert(copy.Size() == 3 && strings.Size() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            StableVector<Obj, std::allocator<Obj>, 4> v;
+            for (int i = 0; i < 10; ++i) {
+                v.EmplaceBack(i);
+            }
+            // Исключение при копировании или инициализации не оставляет лишних объектов
+            v[7].throw_on_copy = true;
+            try {
+                StableVector<Obj, std::allocator<Obj>, 4> copy(v);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(Obj::GetAliveObjectCount() == 10);
+            Obj::default_construction_throw_countdown = 5;
+            try {
+                v.Resize(20);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 10 && Obj::GetAliveObjectCount() == 10);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test27() {
+    using namespace std::literals;
+    {
+        IncrementalVector<uint64_t> v;
+        const size_t SIZE = 100'000;
+        bool seen_migration = false;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+            if (v.IsMigrating()) {
+                seen_migration = true;
+                // Во время переноса элементы читаются из обоих блоков
+                assert(v[0] == 0 && v[i / 2] == i / 2 && v[i] == i);
+            }
+        }
+        assert(seen_migration && v.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == i);
+        }
+        // Константные методы перенос не продолжают, поэтому потоки читают вектор без гонок
+        while (!v.IsMigrating()) {
+            v.PushBack(v.Size());
+        }
+        const IncrementalVector<uint64_t>& cv = v;
+        const size_t size = cv.Size();
+        std::vector<std::thread> readers;
+        std::vector<uint64_t> sums(4);
+        for (size_t t = 0; t < sums.size(); ++t) {
+            readers.emplace_back([&cv, size, &sum = sums[t]] {
+                for (size_t i = 0; i < size; ++i) {
+                    sum += cv[i];
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(std::count(sums.begin(), sums.end(), uint64_t(size) * (size - 1) / 2) == 4);
+        assert(cv.IsMigrating());
+        v.FinishMigration();
+        assert(std::accumulate(cv.begin(), cv.end(), uint64_t(0)) == sums[0]);
+        while (v.Size() > SIZE) {
+            v.PopBack();
+        }
+        // Непрерывный доступ завершает перенос
+        const uint64_t* data = v.Data();
+        assert(!v.IsMigrating() && data[SIZE - 1] == SIZE - 1);
+        assert(std::accumulate(v.begin(), v.end(), uint64_t(0)) == uint64_t(SIZE) * (SIZE - 1) / 2);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            IncrementalVector<Obj> v;
+            for (int i = 0; i < 2048; ++i) {
+                v.EmplaceBack(i);
+            }
+            // Рост с аргументом из вектора и удаление во время переноса
+            v.EmplaceBack(v[5]);
+            assert(v.IsMigrating() && v[2048].id == 5);
+            v.EmplaceBack(v[2000]);
+            assert(v[2049].id == 2000);
+            for (int i = 0; i < 1500; ++i) {
+                v.PopBack();
+            }
+            assert(v.Size() == 550 && v[549].id == 549 && Obj::GetAliveObjectCount() == 550);
+            IncrementalVector<Obj> copy = v;
+            assert(copy.Size() == 550 && copy[100].id == 100);
+            v.Clear();
+            assert(Obj::GetAliveObjectCount() == 550);
+            v = std::move(copy);
+            assert(v.Size() == 550 && v[549].id == 549);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test28() {
+    using namespace std::literals;
+    {
+        ArenaResource arena(4096);
+        const ArenaAllocator<int> alloc(arena);
+        Vector<int, ArenaAllocator<int>> v(alloc);
+        v.PushBack(0);
+        const int* data = v.begin();
+        // Буфер - последнее выделение арены, поэтому растёт на месте
+        for (int i = 1; i < 500; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.begin() == data && v.Capacity() == 512 && arena.SlabCount() == 1);
+
+        // Выделение другого вектора мешает расширению, и буфер переносится
+        Vector<int, ArenaAllocator<int>> other(alloc);
+        other.PushBack(1);
+        v.Resize(600);
+        assert(v.begin() != data && v[499] == 499 && v[599] == 0);
+
+        // Блок больше слэба получает свой слэб
+        Vector<char, ArenaAllocator<char>> big(ArenaAllocator<char>{ arena });
+        big.Reserve(100'000);
+        assert(arena.SlabCount() >= 2 && arena.BytesUsed() >= 100'000);
+    }
+    {
+        ArenaResource arena;
+        const char* first = nullptr;
+        for (int request = 0; request < 3; ++request) {
+            {
+                Vector<std::string, ArenaAllocator<std::string>> strings{ ArenaAllocator<std::string>(arena) };
+                strings.PushBack("hello"s);
+                strings.PushBack(std::string(100, 'x'));
+                Vector<int, ArenaAllocator<int>> numbers{ ArenaAllocator<int>(arena) };
+                numbers.Resize(1000);
+                if (request == 0) {
+                    first = reinterpret_cast<const char*>(strings.begin());
+                }
+                // После Reset память переиспользуется с начала слэба
+                assert(reinterpret_cast<const char*>(strings.begin()) == first);
+            }
+            arena.Reset();
+            assert(arena.BytesUsed() == 0 && arena.SlabCount() == 1);
+        }
+        arena.Release();
+        assert(arena.SlabCount() == 0);
+    }
+    {
+        // По умолчанию используется арена текущего потока
+        ArenaResource::ThreadLocal().Reset();
+        {
+            ArenaVector<double> v(100);
+            assert(v.GetAllocator().Arena().BytesUsed() == 100 * sizeof(double));
+            ArenaVector<double> copy = v;
+            assert(copy == v && ArenaResource::ThreadLocal().BytesUsed() == 200 * sizeof(double));
+        }
+        ArenaResource::ThreadLocal().Reset();
+    }
+}
+
+// Собирает вектор на этапе компиляции
+constexpr InplaceVector<int, 8> MakeTest29Vector() {
+    InplaceVector<int, 8> v;
+    for (int i = 1; i <= 5; ++i) {
+        v.EmplaceBack(i * 10);
+    }
+    v.Insert(v.begin() + 1, 15);
+    v.Erase(v.begin() + 3);
+    v.PopBack();
+    return v;
+}
+
+void Test29() {
+    using namespace std::literals;
+    {
+        constexpr InplaceVector<int, 8> v = MakeTest29Vector();
+        static_assert(v.Size() == 4 && v[0] == 10 && v[1] == 15 && v[2] == 20 && v[3] == 40);
+        static_assert(std::is_trivially_copyable_v<InplaceVector<int, 8>>);
+        struct Route {
+            std::string_view name;
+            int port;
+        };
+        // Тривиально копируемый, но не тривиальный тип хранится в сыром буфере
+        static_assert(std::is_trivially_copyable_v<InplaceVector<Route, 16>>);
+        static_assert(!std::is_trivially_copyable_v<InplaceVector<std::string, 4>>);
+        // Размер хранится в наименьшем подходящем типе
+        static_assert(sizeof(InplaceVector<uint8_t, 16>) == 17);
+
+        // Тривиально копируемый вектор можно передать побайтово
+        InplaceVector<int, 8> copy;
+        std::memcpy(static_cast<void*>(&copy), &v, sizeof(v));
+        assert(copy.Size() == 4 && copy[3] == 40);
+    }
+    {
+        InplaceVector<int, 3> v(2);
+        assert(v.Size() == 2 && v[0] == 0 && v[1] == 0);
+        assert(v.TryEmplaceBack(7) != nullptr && v[2] == 7);
+        assert(v.TryEmplaceBack(8) == nullptr && v.Size() == 3);
+        try {
+            v.PushBack(8);
+            assert(false);
+        }
+        catch (const std::bad_alloc&) {
+        }
+        try {
+            v.Resize(4);
+            assert(false);
+        }
+        catch (const std::bad_alloc&) {
+        }
+        assert(v.Size() == 3);
+        v.Resize(1);
+        assert(v.Size() == 1 && v[0] == 0);
+    }
+    {
+        InplaceVector<std::string, 4> v;
+        v.PushBack("b"s);
+        v.EmplaceBack(3, 'd');
+        v.Insert(v.begin(), "a"s);
+        // Вставка значения, ссылающегося на элемент самого вектора
+        v.Insert(v.begin() + 2, v[0]);
+        assert(v.Size() == 4 && v[0] == "a"s && v[1] == "b"s && v[2] == "a"s && v[3] == "ddd"s);
+        assert(v.TryEmplaceBack("x") == nullptr);
+
+        InplaceVector<std::string, 4> copy = v;
+        v.Erase(v.begin());
+        assert(v.Size() == 3 && v[0] == "b"s && copy.Size() == 4);
+        copy = v;
+        assert(copy.Size() == 3 && copy[2] == "ddd"s);
+        InplaceVector<std::string, 4> moved = std::move(copy);
+        assert(moved.Size() == 3 && moved[0] == "b"s);
+        v.Clear();
+        assert(v.Size() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            InplaceVector<Obj, 4> v(3);
+            assert(Obj::GetAliveObjectCount() == 3);
+            v.Erase(v.begin() + 1);
+            assert(Obj::GetAliveObjectCount() == 2);
+            InplaceVector<Obj, 4> copy = v;
+            assert(Obj::GetAliveObjectCount() == 4);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+// Запись с перемещением, которое может выбросить исключение, и подсчётом копий и перемещений
+struct Test30Record {
+    Test30Record(int id)
+        : id(id)
+        , name(100, 'a' + id % 26) {
+    }
+    Test30Record(const Test30Record& other)
+        : id(other.id)
+        , name(other.name) {
+        ++copies;
+    }
+    Test30Record(Test30Record&& other) noexcept(false)
+        : id(other.id)
+        , name(std::move(other.name)) {
+        if (move_throw_countdown > 0 && --move_throw_countdown == 0) {
+            throw std::runtime_error("move failed");
+        }
+        ++moves;
+    }
+    Test30Record& operator=(const Test30Record&) = default;
+    Test30Record& operator=(Test30Record&&) = default;
+
+    int id;
+    std::string name;
+
+    static inline int copies = 0;
+    static inline int moves = 0;
+    static inline int move_throw_countdown = 0;
+};
+
+void Test30() {
+    using MovingVector = Vector<Test30Record, std::allocator<Test30Record>, DoublingGrowth, NoVectorStats,
+                                AlwaysMoveRelocation>;
+    static_assert(GetRelocationKind<Test30Record>() == RelocationKind::COPY);
+    static_assert(GetRelocationKind<Test30Record, AlwaysMoveRelocation>() == RelocationKind::MOVE);
+    static_assert(!IsNothrowRelocatableV<Test30Record, AlwaysMoveRelocation>);
+    static_assert(IsNothrowRelocatableV<std::string, AlwaysMoveRelocation>);
+    {
+        // По умолчанию выбрасывающее перемещение заменяется копированием при каждой реаллокации
+        Test30Record::copies = Test30Record::moves = 0;
+        Vector<Test30Record> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(Test30Record::copies == 127 && Test30Record::moves == 0);
+    }
+    {
+        Test30Record::copies = Test30Record::moves = 0;
+        MovingVector v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Insert(v.begin() + 50, Test30Record(1000));
+        v.Reserve(1000);
+        v.ShrinkToFit();
+        assert(Test30Record::copies == 0 && v.Size() == 101 && v[50].id == 1000 && v[100].id == 99);
+        MovingVector copy(v);
+        assert(Test30Record::copies == 101 && copy.Size() == 101 && copy[50].id == 1000);
+    }
+    {
+        // Исключение при перемещении оставляет вектор прежнего размера с живыми элементами
+        MovingVector v;
+        v.Reserve(4);
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        Test30Record::move_throw_countdown = 3;
+        try {
+            v.Insert(v.begin() + 1, Test30Record(10));
+            assert(false);
+        }
+        catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4 && v.Capacity() == 4 && v[3].id == 3 && v[3].name == std::string(100, 'd'));
+        Test30Record::move_throw_countdown = 0;
+        v.EmplaceBack(4);
+        assert(v.Size() == 5 && v[4].id == 4);
+    }
+}
+
+// Суммирует элементы представления, не владея ими
+int SumTest31(VectorView<const int> view) {
+    return std::accumulate(view.begin(), view.end(), 0);
+}
+
+void Test31() {
+    using namespace std::literals;
+    {
+        Vector<int> v{ 1, 2, 3, 4, 5, 6 };
+        assert(v.Data() == v.begin() && v.AsView().Size() == 6);
+        assert(SumTest31(v.AsView()) == 21 && SumTest31(v.Slice(1, 3)) == 9);
+
+        // Изменения через представление видны в векторе
+        VectorView<int> tail = v.Slice(3, 3);
+        for (int& x : tail) {
+            x *= 10;
+        }
+        assert(v[3] == 40 && v[5] == 60 && tail[0] == 40);
+        const VectorView<int> sub = tail.Slice(1, 2);
+        assert(sub.Size() == 2 && sub.Data() == v.Data() + 4 && sub[1] == 60);
+        assert(tail.Slice(3, 0).Size() == 0);
+
+        const Vector<int>& cv = v;
+        const VectorView<const int> cview = cv.Slice(0, 2);
+        assert(cview[1] == 2 && SumTest31(sub) == 110);
+        assert(VectorView<const int>().Size() == 0);
+    }
+    {
+        // Вектор из представления выделяет память один раз и копирует только срез
+        Vector<std::string> words{ "a"s, "bb"s, "ccc"s, "dddd"s };
+        const Vector<std::string> middle(words.Slice(1, 2));
+        assert(middle.Size() == 2 && middle.Capacity() == 2 && middle[0] == "bb"s && middle[1] == "ccc"s);
+        assert(words[1] == "bb"s);
+
+        Obj::ResetCounters();
+        Vector<Obj> objs(4);
+        {
+            Vector<Obj> copy(objs.Slice(1, 3));
+            assert(copy.Size() == 3 && Obj::GetAliveObjectCount() == 7 && Obj::num_copied == 3);
+        }
+        // Исключение при копировании третьего элемента разрушает уже созданные копии
+        objs[2].throw_on_copy = true;
+        try {
+            Vector<Obj> copy(objs.AsView());
+            assert(false);
+        }
+        catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 4);
+    }
+}
+
+void Test32() {
+    using namespace std::literals;
+    {
+        // Поиск без ветвлений совпадает с std::lower_bound для любых размеров
+        Vector<int> sorted;
+        for (int size = 0; size < 40; ++size) {
+            for (int key = -1; key <= 2 * size + 1; ++key) {
+                const size_t expected = std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+                assert(FlatLowerBound(sorted.Data(), sorted.Size(), key, std::less<>()) == expected);
+            }
+            sorted.PushBack(2 * size);
+        }
+    }
+    {
+        FlatSet<int> set;
+        assert(set.Insert(5) && set.Insert(1) && set.Insert(3) && !set.Insert(3));
+        assert(set.Size() == 3 && set[0] == 1 && set[2] == 5);
+        assert(set.Contains(3) && !set.Contains(4) && set.Find(4) == nullptr);
+
+        const int batch[] = { 0, 2, 2, 3, 6 };
+        set.InsertSorted(std::begin(batch), std::end(batch));
+        const Vector<int> expected{ 0, 1, 2, 3, 5, 6 };
+        assert(Vector<int>(set.Keys()) == expected);
+        assert(set.Erase(2) == 1 && set.Erase(2) == 0 && set.Size() == 5);
+    }
+    {
+        FlatMap<std::string, int> map;
+        assert(map.Insert("b"s, 2).second && map.Insert("a"s, 1).second);
+        assert(!map.Insert("a"s, 10).second && *map.Find("a"s) == 1);
+        map["c"] += 3;
+        assert(map.Size() == 3 && map.Keys()[2] == "c"s && map.Values()[2] == 3);
+
+        // Разнородный поиск не создаёт временных std::string
+        assert(*map.Find("b"sv) == 2 && map.Contains("c") && !map.Contains("d"sv));
+
+        // Пакетная вставка сливает отсортированные пары за один проход, первое значение побеждает
+        const std::vector<std::pair<std::string, int>> batch{ { "a", 100 }, { "aa", 11 }, { "d", 4 }, { "d", 40 } };
+        map.InsertSorted(batch.begin(), batch.end());
+        assert(map.Size() == 5 && *map.Find("a") == 1 && *map.Find("aa") == 11 && *map.Find("d") == 4);
+        assert(map.Keys()[1] == "aa"s && map.Values()[1] == 11);
+
+        assert(map.Erase("aa"sv) == 1 && map.Erase("zz") == 0 && map.Size() == 4);
+        auto [value, inserted] = map.TryEmplace("e", 5);
+        assert(inserted && *value == 5 && map.Keys()[4] == "e"s);
+    }
+}
+
+void Test33() {
+    using namespace std::literals;
+    {
+        CowVector<std::string> config{ "a"s, "b"s, "c"s };
+        const CowVector<std::string> snapshot = config;
+        // Копия разделяет элементы
+        assert(snapshot.Data() == config.Data() && config.IsShared() && snapshot.IsShared());
+
+        // Первое изменение копирует блок, снимок остаётся прежним
+        config.EmplaceBack("d"s);
+        assert(!config.IsShared() && !snapshot.IsShared() && config.Data() != snapshot.Data());
+        assert(config.Size() == 4 && snapshot.Size() == 3 && snapshot[2] == "c"s);
+        assert(config.Capacity() == 4);
+
+        // Изменение собственного блока не копирует его
+        const std::string* data = config.Data();
+        config[0] = "z"s;
+        config.Erase(config.cbegin() + 1);
+        assert(config.Data() == data && config[0] == "z"s && config[1] == "c"s && snapshot[0] == "a"s);
+
+        CowVector<std::string> reader = snapshot;
+        reader.Clear();
+        assert(reader.Size() == 0 && !snapshot.IsShared() && snapshot.Size() == 3);
+        assert(snapshot.ToVector() == Vector<std::string>({ "a"s, "b"s, "c"s }));
+    }
+    {
+        Obj::ResetCounters();
+        {
+            Vector<Obj> source(5);
+            CowVector<Obj> cow(std::move(source));
+            CowVector<Obj> copy1 = cow;
+            CowVector<Obj> copy2 = copy1;
+            assert(Obj::GetAliveObjectCount() == 5 && Obj::num_copied == 0);
+            copy2.PopBack();
+            assert(Obj::GetAliveObjectCount() == 9 && copy2.Size() == 4 && cow.Size() == 5);
+            copy1 = std::move(copy2);
+            cow = copy1;
+            assert(Obj::GetAliveObjectCount() == 4);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Блок со счётчиком выделяется тем же аллокатором, что и элементы; аллокатор без
+        // конструктора по умолчанию хранится в CowVector и переживает Clear
+        using Alloc = StatefulAllocator<Obj, false>;
+        AllocStats stats;
+        {
+            CowVector<Obj, Alloc> cow{ Alloc(&stats) };
+            assert(cow.GetAllocator().stats == &stats && stats.num_allocations == 0);
+            cow.EmplaceBack(1);
+            assert(stats.num_allocations == 2);
+            CowVector<Obj, Alloc> copy = cow;
+            assert(copy.GetAllocator() == cow.GetAllocator() && stats.num_allocations == 2);
+            copy.EmplaceBack(2);
+            assert(stats.num_allocations == 4 && copy.Size() == 2 && cow.Size() == 1);
+            assert(copy.ToVector().GetAllocator().stats == &stats);
+            cow.Clear();
+            cow.EmplaceBack(3);
+            assert(cow.Size() == 1 && cow[0].id == 3);
+            cow = CowVector<Obj, Alloc>{ Alloc(&stats) };
+            assert(cow.Size() == 0 && cow.ToVector().GetAllocator().stats == &stats);
+        }
+        assert(stats.num_allocations == stats.num_deallocations);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Читатели получают снимок за O(1) и читают его, пока писатель готовит следующий
+        CowVector<int> published(Vector<int>(10'000));
+        std::vector<std::thread> readers;
+        std::vector<long long> sums(4);
+        for (size_t t = 0; t < sums.size(); ++t) {
+            readers.emplace_back([snapshot = published, &sum = sums[t]] {
+                sum = std::accumulate(snapshot.begin(), snapshot.end(), 0LL);
+            });
+        }
+        for (int i = 0; i < 100; ++i) {
+            published[i] = 1;
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(std::count(sums.begin(), sums.end(), 0) == 4);
+        assert(std::accumulate(published.cbegin(), published.cend(), 0) == 100 && !published.IsShared());
+    }
+}
+
+// Регрессионные проверки числа выделений памяти и переносов: лишнее выделение или копирование
+// в vector.h ломает эти утверждения
+void Test34() {
+    using namespace std::literals;
+    {
+        AllocationCounter counter;
+        Vector<int> v;
+        v.Reserve(1000);
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        assert(counter.Allocations() == 1);
+        // Вставка и удаление в пределах ёмкости не выделяют память
+        v.Erase(v.begin());
+        v.Insert(v.begin() + 10, 5);
+        v.PopBack();
+        assert(counter.Allocations() == 1 && counter.Deallocations() == 0);
+    }
+    {
+        AllocationCounter counter;
+        Vector<std::string> strings(100);
+        Vector<int> numbers(1000);
+        Vector<int> copy(numbers);
+        assert(counter.Allocations() == 3);
+        // Рост удвоением выделяет память один раз на каждое удвоение
+        Vector<int> grown;
+        for (int i = 0; i < 1024; ++i) {
+            grown.PushBack(i);
+        }
+        assert(counter.Allocations() == 3 + 11);
+    }
+    {
+        Vector<std::string> a(10);
+        Vector<std::string> b(20);
+        AllocationCounter counter;
+        a.Swap(b);
+        b = std::move(a);
+        Vector<std::string> c(std::move(b));
+        assert(counter.Allocations() == 0 && counter.Deallocations() == 1 && c.Size() == 20);
+    }
+    {
+        // Строки переносятся перемещением: Reserve и ShrinkToFit выделяют только новые буферы
+        Vector<std::string> strings;
+        for (int i = 0; i < 8; ++i) {
+            strings.PushBack(std::string(100, 'a' + i));
+        }
+        AllocationCounter counter;
+        strings.Reserve(100);
+        strings.Insert(strings.begin() + 1, 3, "x"s);
+        strings.ShrinkToFit();
+        assert(counter.Allocations() == 2 && strings[0] == std::string(100, 'a'));
+    }
+    {
+        AllocationCounter counter;
+        Vector<Obj> v(4);
+        Obj::ResetCounters();
+        v.EmplaceBack(1);
+        v.Insert(v.begin(), Obj(2));
+        assert(Obj::num_copied == 0 && Obj::num_moved == 4 + 1 + 1);
+        assert(counter.Allocations() == 2);
+    }
+    {
+        // Контейнеры без кучи и разделяемые копии не выделяют память
+        AllocationCounter counter;
+        InplaceVector<int, 16> inplace;
+        SmallVector<int, 8> small;
+        for (int i = 0; i < 8; ++i) {
+            inplace.PushBack(i);
+            small.PushBack(i);
+        }
+        assert(counter.Allocations() == 0);
+        CowVector<int> cow(Vector<int>(1000));
+        const CowVector<int> snapshot1 = cow;
+        const CowVector<int> snapshot2 = snapshot1;
+        assert(counter.Allocations() == 2 && snapshot2.Size() == 1000);
+        cow[0] = 1;
+        assert(counter.Allocations() == 4);
+    }
+}
+
+void Test35() {
+    using namespace std::literals;
+    {
+        assert(NumaNodeCount() >= 1 && CurrentNumaNode() >= 0);
+        // Большие блоки отображаются и привязываются к узлу, малые выделяются как обычно
+        const NumaAllocator<int> alloc(CurrentNumaNode());
+        assert(alloc.IsMapped(1 << 20) && !alloc.IsMapped(16) && !NumaAllocator<int>().IsMapped(1 << 20));
+        Vector<int, NumaAllocator<int>> v(alloc);
+        v.Resize(100'000);
+        v[99'999] = 7;
+        v.Resize(300'000);
+        assert(v[99'999] == 7 && v[299'999] == 0 && v.GetAllocator() == alloc);
+    }
+    {
+        ThreadPool pool(4);
+        const ParallelPolicy policy{ &pool };
+        ShardedVector<uint64_t> sharded(4);
+        sharded.ForEachShard(
+            [](size_t shard, ShardedVector<uint64_t>::Shard& local) {
+                for (uint64_t i = 0; i < 10'000 + shard; ++i) {
+                    local.PushBack(shard * 100'000 + i);
+                }
+            },
+            policy);
+        assert(sharded.Size() == 40'006 && sharded.GetShard(3).Size() == 10'003);
+
+        AllocationCounter counter;
+        const Vector<uint64_t> gathered = sharded.Gather(policy);
+        // Выделяются только смещения шардов и результат, шарды сохраняют память пустыми
+        assert(counter.Allocations() == 2 && gathered.Size() == 40'006 && sharded.Size() == 0);
+        assert(gathered[0] == 0 && gathered[10'000] == 100'000 && gathered[40'005] == 310'002);
+        assert(sharded.GetShard(0).Capacity() >= 10'000);
+    }
+    {
+        // Свои потоки заполняют каждый свой шард без синхронизации
+        ShardedVector<std::string> sharded(3);
+        std::vector<std::thread> writers;
+        for (size_t t = 0; t < sharded.ShardCount(); ++t) {
+            writers.emplace_back([&sharded, t] {
+                for (int i = 0; i < 1000; ++i) {
+                    sharded.EmplaceBack(t, std::to_string(t) + ':' + std::to_string(i));
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        const Vector<std::string> gathered = sharded.Gather();
+        assert(gathered.Size() == 3000 && sharded.Size() == 0);
+        assert(gathered[0] == "0:0"s && gathered[999] == "0:999"s && gathered[1000] == "1:0"s && gathered[2999] == "2:999"s);
     }
 }
 
@@ -655,9 +2974,38 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
+        Test35();
     }
     catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
+        return 1;
     }
 }
\ No newline at end of file
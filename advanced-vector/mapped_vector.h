@@ -0,0 +1,323 @@
+#pragma once
+#include "vector.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "MappedVector requires POSIX mmap"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum class MappedVectorMode {
+    // Только чтение, изменять элементы нельзя
+    READ_ONLY,
+    // Чтение и запись, несуществующий файл создаётся
+    READ_WRITE,
+};
+
+// Заголовок файла MappedVector. Элементы начинаются с DATA_OFFSET, ёмкость определяется размером файла
+struct MappedVectorHeader {
+    static constexpr char MAGIC[8] = { 'A', 'V', 'E', 'C', 'T', 'O', 'R', '\0' };
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    char magic[8];
+    uint32_t format_version;
+    // Версия схемы данных, которую задаёт пользователь (меняется при изменении T)
+    uint32_t data_version;
+    uint32_t element_size;
+    uint32_t element_align;
+    uint64_t size;
+};
+
+// Вектор тривиально копируемых элементов, хранящийся в файле, отображённом в память через mmap.
+// Открытие не читает данные: страницы подгружаются при первом обращении. Добавление элементов
+// увеличивает файл (ftruncate) и заново отображает его, поэтому итераторы и ссылки при росте
+// инвалидируются, как у Vector. Размер хранится в заголовке и виден после повторного открытия.
+// Одновременная запись в файл из нескольких MappedVector не поддерживается
+template <typename T, typename Growth = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires trivially copyable T");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Смещение данных от начала файла: не меньше строки кэша и кратно alignof(T)
+    static constexpr size_t DATA_OFFSET = ((sizeof(MappedVectorHeader) + 63) / 64 * 64 + alignof(T) - 1)
+                                          / alignof(T) * alignof(T);
+
+    // Открывает файл path. Бросает std::system_error при ошибках ОС и std::runtime_error,
+    // если файл не является MappedVector или записан для другого типа или версии данных
+    explicit MappedVector(const std::string& path, MappedVectorMode mode = MappedVectorMode::READ_WRITE,
+                          uint32_t data_version = 0)
+        : mode_(mode) {
+        const bool writable = mode == MappedVectorMode::READ_WRITE;
+        fd_ = ::open(path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+        }
+        try {
+            struct stat st {};
+            if (::fstat(fd_, &st) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Cannot stat " + path);
+            }
+            if (st.st_size == 0 && writable) {
+                if (::ftruncate(fd_, static_cast<off_t>(FileBytes(0))) != 0) {
+                    throw std::system_error(errno, std::generic_category(), "Cannot resize " + path);
+                }
+                Remap(FileBytes(0));
+                MappedVectorHeader& header = Header();
+                std::copy_n(MappedVectorHeader::MAGIC, sizeof(header.magic), header.magic);
+                header.format_version = MappedVectorHeader::FORMAT_VERSION;
+                header.data_version = data_version;
+                header.element_size = sizeof(T);
+                header.element_align = alignof(T);
+                header.size = 0;
+            }
+            else {
+                if (static_cast<size_t>(st.st_size) < DATA_OFFSET) {
+                    throw std::runtime_error(path + " is not a MappedVector file");
+                }
+                Remap(static_cast<size_t>(st.st_size));
+                CheckHeader(path, data_version);
+            }
+        }
+        catch (...) {
+            Close();
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : mode_(other.mode_)
+        , fd_(std::exchange(other.fd_, -1))
+        , base_(std::exchange(other.base_, nullptr))
+        , mapped_bytes_(std::exchange(other.mapped_bytes_, 0)) {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            mode_ = rhs.mode_;
+            fd_ = std::exchange(rhs.fd_, -1);
+            base_ = std::exchange(rhs.base_, nullptr);
+            mapped_bytes_ = std::exchange(rhs.mapped_bytes_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedVector() {
+        Close();
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+    iterator end() noexcept {
+        return Data() + Size();
+    }
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + Size();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return static_cast<size_t>(Header().size);
+    }
+
+    size_t Capacity() const noexcept {
+        return (mapped_bytes_ - DATA_OFFSET) / sizeof(T);
+    }
+
+    uint32_t DataVersion() const noexcept {
+        return Header().data_version;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size() && IsWritable());
+        return Data()[index];
+    }
+
+    bool IsWritable() const noexcept {
+        return mode_ == MappedVectorMode::READ_WRITE;
+    }
+
+    // Увеличивает файл так, чтобы в нём поместились new_capacity элементов
+    void Reserve(size_t new_capacity) {
+        assert(IsWritable());
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        const size_t new_bytes = FileBytes(new_capacity);
+        if (::ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot grow mapped file");
+        }
+        Remap(new_bytes);
+    }
+
+    // Новые элементы заполняются нулевыми байтами
+    void Resize(size_t new_size) {
+        assert(IsWritable());
+        if (new_size > Size()) {
+            Reserve(new_size);
+            std::memset(static_cast<void*>(Data() + Size()), 0, (new_size - Size()) * sizeof(T));
+        }
+        Header().size = new_size;
+    }
+
+    void PushBack(const T& value) {
+        assert(IsWritable());
+        const size_t size = Size();
+        if (size == Capacity()) {
+            // value может ссылаться на элемент вектора, который переместится при переотображении
+            const T copy = value;
+            Reserve(Growth::template NextCapacity<T>(Capacity(), size + 1));
+            Data()[size] = copy;
+        }
+        else {
+            Data()[size] = value;
+        }
+        Header().size = size + 1;
+    }
+
+    // Диапазон [first, last) не должен ссылаться на элементы этого вектора
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    void Append(InputIt first, InputIt last) {
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (Size() + count > Capacity()) {
+                Reserve(Growth::template NextCapacity<T>(Capacity(), Size() + count));
+            }
+            std::copy(first, last, Data() + Size());
+            Header().size = Size() + count;
+        }
+        else {
+            for (; first != last; ++first) {
+                PushBack(*first);
+            }
+        }
+    }
+
+    void PopBack() noexcept {
+        assert(IsWritable() && Size() != 0);
+        --Header().size;
+    }
+
+    void Clear() noexcept {
+        assert(IsWritable());
+        Header().size = 0;
+    }
+
+    // Синхронно записывает изменённые страницы на диск
+    void Flush() {
+        if (IsWritable() && ::msync(base_, mapped_bytes_, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot flush mapped file");
+        }
+    }
+
+private:
+    static size_t FileBytes(size_t capacity) {
+        static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return (DATA_OFFSET + capacity * sizeof(T) + page_size - 1) / page_size * page_size;
+    }
+
+    MappedVectorHeader& Header() noexcept {
+        return *static_cast<MappedVectorHeader*>(base_);
+    }
+
+    const MappedVectorHeader& Header() const noexcept {
+        return *static_cast<const MappedVectorHeader*>(base_);
+    }
+
+    T* Data() noexcept {
+        return reinterpret_cast<T*>(static_cast<char*>(base_) + DATA_OFFSET);
+    }
+
+    const T* Data() const noexcept {
+        return const_cast<MappedVector&>(*this).Data();
+    }
+
+    void CheckHeader(const std::string& path, uint32_t data_version) const {
+        const MappedVectorHeader& header = Header();
+        if (!std::equal(header.magic, header.magic + sizeof(header.magic), MappedVectorHeader::MAGIC)) {
+            throw std::runtime_error(path + " is not a MappedVector file");
+        }
+        if (header.format_version != MappedVectorHeader::FORMAT_VERSION) {
+            throw std::runtime_error(path + " has unsupported format version "
+                                     + std::to_string(header.format_version));
+        }
+        if (header.element_size != sizeof(T) || header.element_align != alignof(T)) {
+            throw std::runtime_error(path + " stores elements of a different type");
+        }
+        if (header.data_version != data_version) {
+            throw std::runtime_error(path + " has data version " + std::to_string(header.data_version)
+                                     + ", expected " + std::to_string(data_version));
+        }
+        if (header.size > Capacity()) {
+            throw std::runtime_error(path + " is truncated");
+        }
+    }
+
+    // Отображает первые bytes байт файла вместо текущего отображения
+    void Remap(size_t bytes) {
+        const int prot = IsWritable() ? PROT_READ | PROT_WRITE : PROT_READ;
+#if defined(__linux__)
+        void* new_base = base_ != nullptr ? ::mremap(base_, mapped_bytes_, bytes, MREMAP_MAYMOVE)
+                                          : ::mmap(nullptr, bytes, prot, MAP_SHARED, fd_, 0);
+#else
+        void* new_base = ::mmap(nullptr, bytes, prot, MAP_SHARED, fd_, 0);
+#endif
+        if (new_base == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "Cannot map file");
+        }
+#if !defined(__linux__)
+        if (base_ != nullptr) {
+            ::munmap(base_, mapped_bytes_);
+        }
+#endif
+        base_ = new_base;
+        mapped_bytes_ = bytes;
+    }
+
+    void Close() noexcept {
+        if (base_ != nullptr) {
+            ::munmap(base_, mapped_bytes_);
+            base_ = nullptr;
+            mapped_bytes_ = 0;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    MappedVectorMode mode_;
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+};
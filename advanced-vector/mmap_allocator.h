@@ -0,0 +1,172 @@
+#pragma once
+#include "vector.h"
+
+#include <cstdint>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define VECTOR_HAS_MMAP 1
+#include <sys/mman.h>
+#endif
+
+// Аллокатор для очень больших векторов. Блоки от Threshold байт выделяются через mmap,
+// выравниваются по границе и размеру huge-страницы и помечаются MADV_HUGEPAGE, что сокращает
+// промахи TLB при произвольном доступе. С ExplicitHugePages сначала пробуется MAP_HUGETLB
+// (страницы из hugetlbfs, зарезервированные заранее), а при неудаче обычное отображение.
+// На Linux отображённые блоки растут через mremap без копирования элементов: на месте
+// (try_expand) или с переносом страниц (reallocate). Блоки меньше порога и платформы
+// без mmap обслуживаются std::allocator
+template <typename T, size_t Threshold = size_t{ 2 } << 20, bool ExplicitHugePages = false>
+struct MmapAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t HUGE_PAGE_SIZE = size_t{ 2 } << 20;
+    static constexpr size_t THRESHOLD = Threshold;
+
+    static_assert(alignof(T) <= HUGE_PAGE_SIZE, "Alignment of T exceeds the huge page size");
+
+    template <typename U>
+    struct rebind {
+        using other = MmapAllocator<U, Threshold, ExplicitHugePages>;
+    };
+
+    MmapAllocator() = default;
+
+    template <typename U>
+    MmapAllocator(const MmapAllocator<U, Threshold, ExplicitHugePages>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (!IsMapped(n)) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(Map(MappedBytes(n)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (!IsMapped(n)) {
+            std::allocator<T>().deallocate(p, n);
+            return;
+        }
+#if defined(VECTOR_HAS_MMAP)
+        munmap(p, MappedBytes(n));
+#endif
+    }
+
+    // Отображённый блок растёт в пределах последней huge-страницы или через mremap на месте
+    bool try_expand([[maybe_unused]] T* p, size_t old_n, size_t new_n) noexcept {
+        if (!IsMapped(old_n) || new_n > MAX_SIZE) {
+            return false;
+        }
+        const size_t old_bytes = MappedBytes(old_n);
+        const size_t new_bytes = MappedBytes(new_n);
+        if (new_bytes <= old_bytes) {
+            return true;
+        }
+#if defined(__linux__)
+        if (mremap(p, old_bytes, new_bytes, 0) != MAP_FAILED) {
+            AdviseHugePages(p, new_bytes);
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    // Переносит блок под new_n элементов с побайтовым сохранением содержимого. Оба отображённых
+    // блока переносятся через mremap, остальные сочетания копируются. При исключении блок p не меняется
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (p == nullptr) {
+            return allocate(new_n);
+        }
+#if defined(__linux__)
+        if (IsMapped(old_n) && IsMapped(new_n)) {
+            const size_t old_bytes = MappedBytes(old_n);
+            const size_t new_bytes = MappedBytes(new_n);
+            if (old_bytes == new_bytes) {
+                return p;
+            }
+            void* new_p = mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+            if (new_p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            AdviseHugePages(new_p, new_bytes);
+            return static_cast<T*>(new_p);
+        }
+#endif
+        T* new_p = allocate(new_n);
+        std::memcpy(static_cast<void*>(new_p), static_cast<const void*>(p), std::min(old_n, new_n) * sizeof(T));
+        deallocate(p, old_n);
+        return new_p;
+    }
+
+    template <typename U>
+    bool operator==(const MmapAllocator<U, Threshold, ExplicitHugePages>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const MmapAllocator<U, Threshold, ExplicitHugePages>&) const noexcept {
+        return false;
+    }
+
+    // Возвращает true, если блок из n элементов выделяется через mmap
+    static constexpr bool IsMapped([[maybe_unused]] size_t n) noexcept {
+#if defined(VECTOR_HAS_MMAP)
+        return n >= (Threshold + sizeof(T) - 1) / sizeof(T);
+#else
+        return false;
+#endif
+    }
+
+private:
+    static constexpr size_t MAX_SIZE = (std::numeric_limits<size_t>::max() - 2 * HUGE_PAGE_SIZE) / sizeof(T);
+
+    static size_t MappedBytes(size_t n) noexcept {
+        return (n * sizeof(T) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+    static void* Map([[maybe_unused]] size_t bytes) {
+#if defined(VECTOR_HAS_MMAP)
+        if (bytes / sizeof(T) > MAX_SIZE) {
+            throw std::bad_array_new_length();
+        }
+#if defined(MAP_HUGETLB)
+        if constexpr (ExplicitHugePages) {
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                return p;
+            }
+        }
+#endif
+        // Лишняя huge-страница позволяет выровнять начало блока, излишки возвращаются системе
+        void* raw = mmap(nullptr, bytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const uintptr_t raw_addr = reinterpret_cast<uintptr_t>(raw);
+        const uintptr_t addr = (raw_addr + HUGE_PAGE_SIZE - 1) & ~uintptr_t{ HUGE_PAGE_SIZE - 1 };
+        const size_t head = addr - raw_addr;
+        if (head != 0) {
+            munmap(raw, head);
+        }
+        if (const size_t tail = HUGE_PAGE_SIZE - head; tail != 0) {
+            munmap(reinterpret_cast<void*>(addr + bytes), tail);
+        }
+        void* p = reinterpret_cast<void*>(addr);
+        AdviseHugePages(p, bytes);
+        return p;
+#else
+        throw std::bad_alloc();
+#endif
+    }
+
+    static void AdviseHugePages([[maybe_unused]] void* p, [[maybe_unused]] size_t bytes) noexcept {
+#if defined(MADV_HUGEPAGE)
+        // Подсказка необязательна: без поддержки THP блок остаётся на обычных страницах
+        madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    }
+};
+
+// Вектор, большие буферы которого размещаются на huge-страницах и растут через mremap
+template <typename T, typename Growth = DoublingGrowth>
+using HugePageVector = Vector<T, MmapAllocator<T>, Growth>;
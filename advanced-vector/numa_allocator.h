@@ -0,0 +1,156 @@
+#pragma once
+#include "vector.h"
+
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#define VECTOR_HAS_NUMA 1
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Число NUMA-узлов системы: наибольший номер из /sys/devices/system/node/online плюс один.
+// Без NUMA возвращает 1
+inline size_t NumaNodeCount() {
+    static const size_t count = [] {
+        size_t max_node = 0;
+#if defined(VECTOR_HAS_NUMA)
+        std::ifstream in("/sys/devices/system/node/online");
+        std::string online;
+        std::getline(in, online);
+        size_t number = 0;
+        for (const char c : online + ',') {
+            if (c >= '0' && c <= '9') {
+                number = number * 10 + static_cast<size_t>(c - '0');
+            }
+            else {
+                max_node = std::max(max_node, number);
+                number = 0;
+            }
+        }
+#endif
+        return max_node + 1;
+    }();
+    return count;
+}
+
+// Узел, на котором сейчас выполняется вызывающий поток (0, если узнать нельзя)
+inline int CurrentNumaNode() noexcept {
+#if defined(VECTOR_HAS_NUMA) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+// Аллокатор, размещающий блоки на заданном NUMA-узле. Блоки от Threshold байт отображаются
+// через mmap, и их страницы привязываются к узлу через mbind с политикой MPOL_PREFERRED:
+// память берётся с узла node, пока на нём есть место. Меньшие блоки, аллокатор без узла
+// (node < 0) и системы без NUMA обслуживаются std::allocator. Если ядро отказало в mbind,
+// страницы размещаются по first touch. Экземпляры равны, если привязаны к одному узлу,
+// и распространяются при присваивании и обмене вместе с блоками
+template <typename T, size_t Threshold = size_t{ 64 } << 10>
+class NumaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    static constexpr size_t THRESHOLD = Threshold;
+
+    template <typename U>
+    struct rebind {
+        using other = NumaAllocator<U, Threshold>;
+    };
+
+    NumaAllocator() noexcept = default;
+
+    explicit NumaAllocator(int node) noexcept
+        : node_(node) {
+    }
+
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U, Threshold>& other) noexcept
+        : node_(other.Node()) {
+    }
+
+    T* allocate(size_t n) {
+#if defined(VECTOR_HAS_NUMA)
+        if (IsMapped(n)) {
+            if (n > (std::numeric_limits<size_t>::max() - PAGE_BYTES) / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            const size_t bytes = MappedBytes(n);
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            Bind(p, bytes);
+            return static_cast<T*>(p);
+        }
+#endif
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (!IsMapped(n)) {
+            std::allocator<T>().deallocate(p, n);
+            return;
+        }
+#if defined(VECTOR_HAS_NUMA)
+        munmap(p, MappedBytes(n));
+#endif
+    }
+
+    // Узел, к которому привязан аллокатор, или -1
+    int Node() const noexcept {
+        return node_;
+    }
+
+    // Возвращает true, если блок из n элементов отображается и привязывается к узлу
+    bool IsMapped([[maybe_unused]] size_t n) const noexcept {
+#if defined(VECTOR_HAS_NUMA)
+        return node_ >= 0 && static_cast<size_t>(node_) < MAX_NODES && n >= (Threshold + sizeof(T) - 1) / sizeof(T);
+#else
+        return false;
+#endif
+    }
+
+    template <typename U>
+    bool operator==(const NumaAllocator<U, Threshold>& other) const noexcept {
+        return node_ == other.Node();
+    }
+    template <typename U>
+    bool operator!=(const NumaAllocator<U, Threshold>& other) const noexcept {
+        return node_ != other.Node();
+    }
+
+private:
+    static constexpr size_t PAGE_BYTES = 4096;
+    static constexpr size_t MAX_NODES = 256;
+    // Значение MPOL_PREFERRED из <numaif.h>, который есть не везде
+    static constexpr int MPOL_PREFERRED_MODE = 1;
+
+    static size_t MappedBytes(size_t n) noexcept {
+        return (n * sizeof(T) + PAGE_BYTES - 1) & ~(PAGE_BYTES - 1);
+    }
+
+    void Bind([[maybe_unused]] void* p, [[maybe_unused]] size_t bytes) const noexcept {
+#if defined(VECTOR_HAS_NUMA) && defined(SYS_mbind)
+        constexpr size_t BITS = sizeof(unsigned long) * 8;
+        unsigned long mask[MAX_NODES / BITS] = {};
+        mask[node_ / BITS] = 1UL << (node_ % BITS);
+        // Ядро считает maxnode на единицу больше числа битов маски
+        syscall(SYS_mbind, p, bytes, MPOL_PREFERRED_MODE, mask, MAX_NODES + 1, 0);
+#endif
+    }
+
+    int node_ = -1;
+};
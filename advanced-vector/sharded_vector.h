@@ -0,0 +1,122 @@
+#pragma once
+#include "numa_allocator.h"
+#include "vector.h"
+#include "vector_parallel.h"
+
+// Вектор из нескольких независимых шардов для фазы сбора данных многими потоками.
+// Каждый шард - отдельный Vector, который в каждый момент использует один поток, поэтому
+// добавление в свой шард не требует синхронизации. Шарды лежат в разных строках кэша,
+// а их память при первом обращении к шарду привязывается к NUMA-узлу обратившегося потока
+// (NumaAllocator), так что заполнение не гоняет данные между сокетами.
+// Gather собирает все шарды в один Vector с одним выделением памяти
+template <typename T>
+class ShardedVector {
+public:
+    using value_type = T;
+    using Shard = Vector<T, NumaAllocator<T>>;
+
+    // По одному шарду на участника пула по умолчанию
+    explicit ShardedVector(size_t shard_count = ThreadPool::Default().Size())
+        : slots_(std::max<size_t>(shard_count, 1)) {
+    }
+
+    size_t ShardCount() const noexcept {
+        return slots_.Size();
+    }
+
+    // Шард index для монопольного использования вызывающим потоком. Первое обращение
+    // привязывает память шарда к NUMA-узлу этого потока
+    Shard& Local(size_t index) {
+        Slot& slot = slots_[index];
+        if (!slot.bound) {
+            assert(slot.shard.Capacity() == 0);
+            Shard bound{ NumaAllocator<T>(CurrentNumaNode()) };
+            slot.shard.Swap(bound);
+            slot.bound = true;
+        }
+        return slot.shard;
+    }
+
+    const Shard& GetShard(size_t index) const noexcept {
+        return slots_[index].shard;
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(size_t shard, Args&&... args) {
+        return Local(shard).EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    // Вызывает body(index, shard) для каждого шарда из потоков пула. Каждый шард в каждый
+    // момент обрабатывается одним потоком
+    template <typename Body>
+    void ForEachShard(Body body, const ParallelPolicy& policy = PAR) {
+        policy.Pool().ParallelFor(slots_.Size(), 1, [this, &body](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                body(i, Local(i));
+            }
+        });
+    }
+
+    // Суммарное число элементов. Не должен выполняться одновременно с изменением шардов
+    size_t Size() const noexcept {
+        size_t size = 0;
+        for (const Slot& slot : slots_) {
+            size += slot.shard.Size();
+        }
+        return size;
+    }
+
+    // Разрушает элементы, сохраняя память шардов для следующей фазы
+    void Clear() noexcept {
+        for (Slot& slot : slots_) {
+            slot.shard.Clear();
+        }
+    }
+
+    // Переносит элементы всех шардов по порядку шардов в один Vector и очищает шарды. Память
+    // результата выделяется один раз, а элементы переносятся параллельно. Если перемещение
+    // элемента выбросит исключение, шарды сохраняют элементы, часть которых может быть перемещена
+    Vector<T> Gather(const ParallelPolicy& policy = PAR) {
+        Vector<size_t> offsets(slots_.Size() + 1);
+        for (size_t i = 0; i < slots_.Size(); ++i) {
+            offsets[i + 1] = offsets[i] + slots_[i].shard.Size();
+        }
+        const size_t total = offsets[slots_.Size()];
+        Vector<T> result;
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>) {
+            // Каждый шард копируется одним memcpy, разные шарды - разными потоками
+            result.ResizeAndOverwrite(total, [&](T* dst, size_t /*size*/) {
+                policy.Pool().ParallelFor(slots_.Size(), 1, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        if (const size_t size = slots_[i].shard.Size(); size != 0) {
+                            std::memcpy(static_cast<void*>(dst + offsets[i]),
+                                        static_cast<const void*>(slots_[i].shard.Data()), size * sizeof(T));
+                        }
+                    }
+                });
+                return total;
+            });
+        }
+        else {
+            // Элементы делятся между потоками равномерно независимо от размеров шардов
+            result = Vector<T>(
+                total,
+                [&](size_t i) {
+                    const size_t shard = std::upper_bound(offsets.begin(), offsets.end(), i) - offsets.begin() - 1;
+                    return std::move(slots_[shard].shard[i - offsets[shard]]);
+                },
+                policy);
+        }
+        Clear();
+        return result;
+    }
+
+private:
+    // Шард занимает отдельные строки кэша, чтобы размеры соседних шардов не делили строку
+    struct alignas(64) Slot {
+        Shard shard;
+        bool bound = false;
+    };
+
+    Vector<Slot> slots_;
+};
@@ -0,0 +1,261 @@
+#pragma once
+#include "vector.h"
+
+// Вектор, хранящий до N элементов во встроенном буфере внутри объекта и переходящий
+// в динамическую память RawMemory, только когда элементов становится больше.
+// Интерфейс совпадает с Vector. Аллокатор задаётся при создании и не распространяется
+// при присваивании и обмене, поэтому у обмениваемых векторов аллокаторы должны быть равны
+template <typename T, size_t N, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class SmallVector {
+    static_assert(N > 0, "Inline capacity must be positive");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    static constexpr size_t INLINE_CAPACITY = N;
+
+    iterator begin() noexcept {
+        return Buffer();
+    }
+    iterator end() noexcept {
+        return Buffer() + size_;
+    }
+    const_iterator begin() const noexcept {
+        return Buffer();
+    }
+    const_iterator end() const noexcept {
+        return Buffer() + size_;
+    }
+    const_iterator cbegin() const noexcept {
+        return Buffer();
+    }
+    const_iterator cend() const noexcept {
+        return Buffer() + size_;
+    }
+
+    SmallVector() = default;
+
+    explicit SmallVector(const Alloc& alloc) noexcept
+        : heap_(alloc) {
+    }
+
+    explicit SmallVector(size_t size, const Alloc& alloc = Alloc())
+        : heap_(alloc) {
+        Reserve(size);
+        std::uninitialized_value_construct_n(Buffer(), size);
+        size_ = size;
+    }
+
+    SmallVector(const SmallVector& other)
+        : SmallVector(other, std::allocator_traits<Alloc>::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    SmallVector(const SmallVector& other, const Alloc& alloc)
+        : heap_(alloc) {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.Buffer(), other.size_, Buffer());
+        size_ = other.size_;
+    }
+
+    // Динамическая память забирается у other целиком, элементы встроенного буфера перемещаются поштучно
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : heap_(std::move(other.heap_)) {
+        if (!IsInline()) {
+            size_ = std::exchange(other.size_, 0);
+        }
+        else {
+            MoveElementsFrom(other);
+        }
+    }
+
+    ~SmallVector() {
+        std::destroy_n(Buffer(), size_);
+    }
+
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            if (rhs.size_ > Capacity()) {
+                SmallVector rhs_copy(rhs, GetAllocator());
+                *this = std::move(rhs_copy);
+            }
+            else if (rhs.size_ < size_) {
+                std::copy_n(rhs.Buffer(), rhs.size_, Buffer());
+                std::destroy_n(Buffer() + rhs.size_, size_ - rhs.size_);
+                size_ = rhs.size_;
+            }
+            else {
+                std::copy_n(rhs.Buffer(), size_, Buffer());
+                std::uninitialized_copy_n(rhs.Buffer() + size_, rhs.size_ - size_, Buffer() + size_);
+                size_ = rhs.size_;
+            }
+        }
+        return *this;
+    }
+
+    // При неравных аллокаторах элементы rhs переносятся в память этого вектора, выделение которой
+    // может выбросить исключение, поэтому noexcept гарантируется только для всегда равных аллокаторов
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                       && std::allocator_traits<Alloc>::is_always_equal::value) {
+        if (this != &rhs) {
+            Clear();
+            if (!rhs.IsInline() && GetAllocator() == rhs.GetAllocator()) {
+                // Прежняя динамическая память освобождается вместе с rhs_heap
+                RawMemory<T, Alloc> rhs_heap(GetAllocator());
+                rhs_heap.SwapBuffers(rhs.heap_);
+                heap_.SwapBuffers(rhs_heap);
+                size_ = std::exchange(rhs.size_, 0);
+            }
+            else {
+                Reserve(rhs.size_);
+                MoveElementsFrom(rhs);
+            }
+        }
+        return *this;
+    }
+
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>
+                                           && std::allocator_traits<Alloc>::is_always_equal::value) {
+        if (!IsInline() && !other.IsInline()) {
+            heap_.SwapBuffers(other.heap_);
+            std::swap(size_, other.size_);
+        }
+        else {
+            SmallVector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+    }
+
+    const Alloc& GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T, Alloc> new_data(new_capacity, GetAllocator());
+        RelocateN(Buffer(), size_, new_data.GetAddress());
+        // Прежняя динамическая память (если была) освобождается вместе с new_data
+        heap_.Swap(new_data);
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            Reserve(new_size);
+            std::uninitialized_value_construct_n(Buffer() + size_, new_size - size_);
+        }
+        else {
+            std::destroy_n(Buffer() + new_size, size_ - new_size);
+        }
+        size_ = new_size;
+    }
+
+    void Clear() noexcept {
+        std::destroy_n(Buffer(), size_);
+        size_ = 0;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        std::destroy_at(Buffer() + size_ - 1);
+        --size_;
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return *Emplace(end(), std::forward<Args>(args)...);
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t pos_idx = pos - cbegin();
+        if (size_ == Capacity()) {
+            RawMemory<T, Alloc> new_data(Growth::template NextCapacity<T>(Capacity(), size_ + 1), GetAllocator());
+            // Новый элемент конструируется до переноса, так как args могут ссылаться на элементы вектора
+            T* new_elem = new (new_data.GetAddress() + pos_idx) T(std::forward<Args>(args)...);
+            try {
+                RelocateWithGap(Buffer(), size_, new_data.GetAddress(), pos_idx, 1);
+            }
+            catch (...) {
+                std::destroy_at(new_elem);
+                throw;
+            }
+            heap_.Swap(new_data);
+        }
+        else {
+            EmplaceWithinCapacity(Buffer(), size_, pos_idx, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return begin() + pos_idx;
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t pos_idx = pos - cbegin();
+        std::move(begin() + pos_idx + 1, end(), begin() + pos_idx);
+        std::destroy_at(end() - 1);
+        --size_;
+        return begin() + pos_idx;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    // Возвращает true, пока элементы хранятся во встроенном буфере
+    bool IsInline() const noexcept {
+        return heap_.Capacity() == 0;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Buffer()[index];
+    }
+
+private:
+    T* Buffer() noexcept {
+        return IsInline() ? std::launder(reinterpret_cast<T*>(inline_)) : heap_.GetAddress();
+    }
+
+    const T* Buffer() const noexcept {
+        return const_cast<SmallVector&>(*this).Buffer();
+    }
+
+    // Перемещает элементы other в собственную память достаточной ёмкости и очищает other
+    void MoveElementsFrom(SmallVector& other) {
+        assert(size_ == 0 && other.size_ <= Capacity());
+        std::uninitialized_move_n(other.Buffer(), other.size_, Buffer());
+        size_ = other.size_;
+        other.Clear();
+    }
+
+    RawMemory<T, Alloc> heap_;
+    size_t size_ = 0;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+};
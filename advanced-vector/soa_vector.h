@@ -0,0 +1,461 @@
+#pragma once
+#include "vector.h"
+
+#include <tuple>
+
+// Непрерывный участок одного столбца SoAVector
+template <typename T>
+using SoAColumn = VectorView<T>;
+
+// Вектор записей из полей Fields..., в котором каждое поле хранится в своём буфере RawMemory
+// (structure of arrays). Проход по одному полю читает только его данные подряд и векторизуется
+// компилятором, тогда как в Vector<Struct> каждая строка кэша несёт и ненужные поля.
+// Все столбцы имеют общие размер и ёмкость и перевыделяются вместе. Строки доступны через
+// прокси-итератор, разыменование которого даёт std::tuple ссылок на поля
+template <typename... Fields>
+class SoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector requires at least one field");
+
+    using Columns = std::tuple<RawMemory<Fields>...>;
+    using Indices = std::index_sequence_for<Fields...>;
+
+    // Перенос столбца не бросает исключений. Остальные столбцы копируются, а если копирование
+    // невозможно, перемещаются до переноса этих
+    template <typename T>
+    static constexpr bool NOTHROW_RELOCATE = IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>;
+
+public:
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+
+    static constexpr size_t FIELD_COUNT = sizeof...(Fields);
+
+    template <bool IS_CONST>
+    class RowIterator {
+        using Owner = std::conditional_t<IS_CONST, const SoAVector, SoAVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = SoAVector::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IS_CONST, const_reference, SoAVector::reference>;
+        using pointer = void;
+
+        RowIterator() = default;
+
+        RowIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        // Неконстантный итератор преобразуется в константный
+        template <bool OTHER_CONST, typename = std::enable_if_t<IS_CONST && !OTHER_CONST>>
+        RowIterator(const RowIterator<OTHER_CONST>& other) noexcept
+            : owner_(other.owner_)
+            , index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        size_t Index() const noexcept {
+            return index_;
+        }
+
+        RowIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+        RowIterator operator++(int) noexcept {
+            RowIterator old = *this;
+            ++index_;
+            return old;
+        }
+        RowIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+        RowIterator operator--(int) noexcept {
+            RowIterator old = *this;
+            --index_;
+            return old;
+        }
+        RowIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+        RowIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+        RowIterator operator+(difference_type offset) const noexcept {
+            return RowIterator(owner_, index_ + offset);
+        }
+        friend RowIterator operator+(difference_type offset, const RowIterator& it) noexcept {
+            return it + offset;
+        }
+        RowIterator operator-(difference_type offset) const noexcept {
+            return RowIterator(owner_, index_ - offset);
+        }
+        difference_type operator-(const RowIterator& other) const noexcept {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        bool operator==(const RowIterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+        bool operator!=(const RowIterator& other) const noexcept {
+            return index_ != other.index_;
+        }
+        bool operator<(const RowIterator& other) const noexcept {
+            return index_ < other.index_;
+        }
+        bool operator>(const RowIterator& other) const noexcept {
+            return index_ > other.index_;
+        }
+        bool operator<=(const RowIterator& other) const noexcept {
+            return index_ <= other.index_;
+        }
+        bool operator>=(const RowIterator& other) const noexcept {
+            return index_ >= other.index_;
+        }
+
+    private:
+        friend class RowIterator<!IS_CONST>;
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = RowIterator<false>;
+    using const_iterator = RowIterator<true>;
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    SoAVector() = default;
+
+    explicit SoAVector(size_t size) {
+        Resize(size);
+    }
+
+    SoAVector(const SoAVector& other)
+        : columns_(RawMemory<Fields>(other.size_)...) {
+        CopyColumns(other, Indices{});
+        size_ = other.size_;
+    }
+
+    SoAVector(SoAVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    SoAVector& operator=(const SoAVector& rhs) {
+        if (this != &rhs) {
+            SoAVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SoAVector& operator=(SoAVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            columns_ = std::move(rhs.columns_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    ~SoAVector() {
+        Clear();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+
+    template <size_t I>
+    FieldType<I>& Get(size_t index) noexcept {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    template <size_t I>
+    const FieldType<I>& Get(size_t index) const noexcept {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    // Все значения поля I подряд. Участок действителен до перевыделения памяти
+    template <size_t I>
+    SoAColumn<FieldType<I>> Column() noexcept {
+        return { std::get<I>(columns_).GetAddress(), size_ };
+    }
+
+    template <size_t I>
+    SoAColumn<const FieldType<I>> Column() const noexcept {
+        return { std::get<I>(columns_).GetAddress(), size_ };
+    }
+
+    // Перевыделяет все столбцы. Если перенос какого-либо поля бросит исключение, вектор
+    // не изменяется. Только поля без копирования, перемещение которых бросает исключения,
+    // могут остаться перемещёнными (как при AlwaysMoveRelocation в Vector)
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        Columns new_columns{ RawMemory<Fields>(new_capacity)... };
+        RelocateColumns(new_columns, Indices{});
+        columns_.swap(new_columns);
+    }
+
+    // Новые строки инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            Reserve(new_size);
+            ValueConstructRows(size_, new_size, Indices{});
+        }
+        else {
+            DestroyRows(new_size, size_, Indices{});
+        }
+        size_ = new_size;
+    }
+
+    // Добавляет строку, поле I которой создаётся из args[I]. Аргументы могут ссылаться
+    // на элементы вектора. При исключении вектор не изменяется, с той же оговоркой, что и Reserve
+    template <typename... Args>
+    reference EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == FIELD_COUNT, "EmplaceBack takes one argument per field");
+        if (size_ < Capacity()) {
+            ConstructRow(columns_, size_, Indices{}, std::forward<Args>(args)...);
+        }
+        else {
+            const size_t new_capacity = DoublingGrowth::NextCapacity<value_type>(Capacity(), size_ + 1);
+            Columns new_columns{ RawMemory<Fields>(new_capacity)... };
+            ConstructRow(new_columns, size_, Indices{}, std::forward<Args>(args)...);
+            try {
+                RelocateColumns(new_columns, Indices{});
+            }
+            catch (...) {
+                DestroyRow(new_columns, size_, Indices{});
+                throw;
+            }
+            columns_.swap(new_columns);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    reference PushBack(const value_type& row) {
+        return std::apply(
+            [this](const Fields&... fields) -> reference {
+                return EmplaceBack(fields...);
+            },
+            row);
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        DestroyRow(columns_, size_, Indices{});
+    }
+
+    iterator Erase(const_iterator pos) {
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет строки [first, last), сдвигая хвост каждого столбца один раз
+    iterator Erase(const_iterator first, const_iterator last) {
+        const size_t first_idx = first.Index();
+        const size_t count = last.Index() - first_idx;
+        EraseRows(first_idx, count, Indices{});
+        size_ -= count;
+        return begin() + first_idx;
+    }
+
+    void Clear() noexcept {
+        DestroyRows(0, size_, Indices{});
+        size_ = 0;
+    }
+
+    void Swap(SoAVector& other) noexcept {
+        columns_.swap(other.columns_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    template <size_t... I>
+    reference Row(size_t index, std::index_sequence<I...>) noexcept {
+        return reference(std::get<I>(columns_)[index]...);
+    }
+
+    template <size_t... I>
+    const_reference Row(size_t index, std::index_sequence<I...>) const noexcept {
+        return const_reference(std::get<I>(columns_)[index]...);
+    }
+
+    // Создаёт поля строки index в columns. При исключении созданные поля разрушаются
+    template <size_t... I, typename... Args>
+    static void ConstructRow(Columns& columns, size_t index, std::index_sequence<I...>, Args&&... args) {
+        size_t constructed = 0;
+        try {
+            ((new (std::get<I>(columns) + index) FieldType<I>(std::forward<Args>(args)), ++constructed), ...);
+        }
+        catch (...) {
+            ((I < constructed ? std::destroy_at(std::get<I>(columns) + index) : void()), ...);
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    static void DestroyRow(Columns& columns, size_t index, std::index_sequence<I...>) noexcept {
+        (std::destroy_at(std::get<I>(columns) + index), ...);
+    }
+
+    template <size_t... I>
+    void DestroyRows(size_t first, size_t last, std::index_sequence<I...>) noexcept {
+        (std::destroy(std::get<I>(columns_) + first, std::get<I>(columns_) + last), ...);
+    }
+
+    // Инициализирует строки [first, last) значением. При исключении созданные поля разрушаются
+    template <size_t... I>
+    void ValueConstructRows(size_t first, size_t last, std::index_sequence<I...>) {
+        size_t constructed = 0;
+        try {
+            ((std::uninitialized_value_construct(std::get<I>(columns_) + first, std::get<I>(columns_) + last),
+              ++constructed),
+             ...);
+        }
+        catch (...) {
+            ((I < constructed ? std::destroy(std::get<I>(columns_) + first, std::get<I>(columns_) + last) : void()),
+             ...);
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void CopyColumns(const SoAVector& other, std::index_sequence<I...>) {
+        size_t copied = 0;
+        try {
+            ((std::uninitialized_copy_n(std::get<I>(other.columns_).GetAddress(), other.size_,
+                                        std::get<I>(columns_).GetAddress()),
+              ++copied),
+             ...);
+        }
+        catch (...) {
+            ((I < copied ? std::destroy(std::get<I>(columns_) + 0, std::get<I>(columns_) + other.size_) : void()), ...);
+            throw;
+        }
+    }
+
+    // Переносит строки в new_columns. Сначала копируются (или, если копирование невозможно,
+    // перемещаются) поля, перенос которых может бросить исключение, и только потом переносятся
+    // остальные. При исключении созданные копии разрушаются, а исходные столбцы остаются живыми
+    template <size_t... I>
+    void RelocateColumns(Columns& new_columns, std::index_sequence<I...>) {
+        size_t copied = 0;
+        try {
+            ((ConstructInColumn<I>(new_columns), ++copied), ...);
+        }
+        catch (...) {
+            ((I < copied && !NOTHROW_RELOCATE<FieldType<I>>
+                  ? std::destroy(std::get<I>(new_columns) + 0, std::get<I>(new_columns) + size_) : void()),
+             ...);
+            throw;
+        }
+        (FinishRelocation<I>(new_columns), ...);
+    }
+
+    template <size_t I>
+    void ConstructInColumn(Columns& new_columns) {
+        if constexpr (!NOTHROW_RELOCATE<FieldType<I>>) {
+            UninitializedMoveIfNoexceptN(std::get<I>(columns_).GetAddress(), size_, std::get<I>(new_columns).GetAddress());
+        }
+    }
+
+    template <size_t I>
+    void FinishRelocation(Columns& new_columns) noexcept {
+        if constexpr (NOTHROW_RELOCATE<FieldType<I>>) {
+            RelocateN(std::get<I>(columns_).GetAddress(), size_, std::get<I>(new_columns).GetAddress());
+        }
+        else {
+            std::destroy_n(std::get<I>(columns_).GetAddress(), size_);
+        }
+    }
+
+    // Сначала хвосты всех столбцов, которые нельзя перенести побайтово, сдвигаются присваиванием,
+    // которое может выбросить исключение. Тогда все объекты остаются живыми, size_ верен,
+    // и строка может лишь частично сдвинуться (базовая гарантия). Освобождённые места
+    // разрушаются и побайтовые столбцы сдвигаются только после этого
+    template <size_t... I>
+    void EraseRows(size_t first_idx, size_t count, std::index_sequence<I...>) {
+        (ShiftColumnRows<I>(first_idx, count), ...);
+        (FinishColumnErase<I>(first_idx, count), ...);
+    }
+
+    template <size_t I>
+    void ShiftColumnRows(size_t first_idx, size_t count) {
+        using T = FieldType<I>;
+        if constexpr (!IsTriviallyRelocatableV<T>) {
+            T* pos = std::get<I>(columns_) + first_idx;
+            std::move(pos + count, std::get<I>(columns_) + size_, pos);
+        }
+    }
+
+    template <size_t I>
+    void FinishColumnErase(size_t first_idx, size_t count) noexcept {
+        using T = FieldType<I>;
+        T* pos = std::get<I>(columns_) + first_idx;
+        T* end = std::get<I>(columns_) + size_;
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            std::destroy_n(pos, count);
+            std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count),
+                         (size_ - first_idx - count) * sizeof(T));
+        }
+        else {
+            std::destroy_n(end - count, count);
+        }
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+};
@@ -1,28 +1,281 @@
 #pragma once
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#if defined(__GLIBC__) || defined(_MSC_VER)
+#include <malloc.h>
+#endif
 #include <new>
+#include <stdexcept>
 #include <utility>
 #include <memory>
+#include <type_traits>
 
+// Признак того, что объект типа T можно перенести в другую область памяти побайтовым копированием,
+// не вызывая конструктор перемещения у нового объекта и деструктор у старого.
+// Может быть специализирован пользователем для своих типов (дескрипторов, умных указателей и т.п.)
 template <typename T>
-class RawMemory {
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {
+};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {
+};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Аллокатор может предоставить необязательные методы для роста без переноса элементов:
+// bool try_expand(T* p, size_t old_n, size_t new_n) - расширяет блок на месте, не перемещая его;
+// T* reallocate(T* p, size_t old_n, size_t new_n) - перевыделяет блок, перенося байты (как realloc).
+template <typename Alloc, typename = void>
+struct AllocatorHasTryExpand : std::false_type {
+};
+
+template <typename Alloc>
+struct AllocatorHasTryExpand<Alloc, std::void_t<decltype(std::declval<Alloc&>().try_expand(
+    std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t{}, size_t{}))>> : std::true_type {
+};
+
+template <typename Alloc, typename = void>
+struct AllocatorHasReallocate : std::false_type {
+};
+
+template <typename Alloc>
+struct AllocatorHasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t{}, size_t{}))>> : std::true_type {
+};
+
+// Аллокатор на основе malloc/realloc/free. Умеет расширять блок на месте,
+// если это позволяет менеджер кучи, и перевыделять блок через realloc
+template <typename T>
+struct ReallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not support over-aligned types");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    ReallocAllocator() = default;
+
+    template <typename U>
+    ReallocAllocator(const ReallocAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        void* p = std::malloc(n * sizeof(T));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        std::free(p);
+    }
+
+    bool try_expand([[maybe_unused]] T* p, size_t /*old_n*/, [[maybe_unused]] size_t new_n) noexcept {
+#if defined(__GLIBC__)
+        return new_n * sizeof(T) <= malloc_usable_size(p);
+#elif defined(_MSC_VER)
+        return _expand(p, new_n * sizeof(T)) != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    T* reallocate(T* p, size_t /*old_n*/, size_t new_n) {
+        void* new_p = std::realloc(static_cast<void*>(p), new_n * sizeof(T));
+        if (new_p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(new_p);
+    }
+
+    template <typename U>
+    bool operator==(const ReallocAllocator<U>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const ReallocAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+// Аллокатор, выравнивающий блоки по границе Alignment (но не меньше alignof(T)), например
+// по строке кэша или по ширине SIMD-регистра. Размер блока округляется вверх до кратного
+// Alignment, чтобы хвост буфера не делил строку кэша с чужими данными, а try_expand растёт
+// в пределах этого запаса без перевыделения
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t ALIGNMENT = std::max(Alignment, alignof(T));
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > MAX_SIZE) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(BlockBytes(n), std::align_val_t{ ALIGNMENT }));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ::operator delete(p, BlockBytes(n), std::align_val_t{ ALIGNMENT });
+    }
+
+    bool try_expand(T* /*p*/, size_t old_n, size_t new_n) noexcept {
+        return new_n <= MAX_SIZE && BlockBytes(new_n) == BlockBytes(old_n);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return false;
+    }
+
+private:
+    // Наибольшее n, для которого округлённый размер блока не переполняет size_t
+    static constexpr size_t MAX_SIZE = (std::numeric_limits<size_t>::max() - ALIGNMENT) / sizeof(T);
+
+    static size_t BlockBytes(size_t n) noexcept {
+        return (n * sizeof(T) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+};
+
+// Способ, которым элементы переносятся в новую память при реаллокации
+enum class RelocationKind {
+    BITWISE,
+    MOVE,
+    COPY,
+};
+
+// Политика переноса по умолчанию: элементы с выбрасывающим перемещением копируются,
+// и исключение при реаллокации оставляет вектор прежним (строгая гарантия)
+struct MoveIfNoexceptRelocation {
+    template <typename T>
+    static constexpr bool MOVE = std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>;
+};
+
+// Элементы всегда перемещаются. Если перемещение выбросит исключение, вектор сохраняет размер
+// и остаётся корректным, но часть элементов может оказаться перемещённой (базовая гарантия)
+struct AlwaysMoveRelocation {
+    template <typename T>
+    static constexpr bool MOVE = true;
+};
+
+// Истинно, если перенос элементов по политике Relocation не выбрасывает исключений
+template <typename T, typename Relocation = MoveIfNoexceptRelocation>
+inline constexpr bool IsNothrowRelocatableV =
+    IsTriviallyRelocatableV<T>
+    || (Relocation::template MOVE<T> ? std::is_nothrow_move_constructible_v<T> : std::is_nothrow_copy_constructible_v<T>);
+
+template <typename T, typename Relocation = MoveIfNoexceptRelocation>
+constexpr RelocationKind GetRelocationKind() noexcept {
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        return RelocationKind::BITWISE;
+    }
+    else if constexpr (Relocation::template MOVE<T>) {
+        return RelocationKind::MOVE;
+    }
+    else {
+        return RelocationKind::COPY;
+    }
+}
+
+// Политика сбора статистики, выбираемая при компиляции. RawMemory и Vector вызывают её статические
+// методы в точках выделения памяти, реаллокации и сдвига элементов. Эта политика ничего не делает
+// и полностью удаляется компилятором; сбора статистики с реестром - VectorStats в vector_stats.h
+struct NoVectorStats {
+    // Выделен блок памяти
+    static void OnAllocate(size_t /*bytes*/) noexcept {
+    }
+    // Освобождён блок памяти
+    static void OnDeallocate(size_t /*bytes*/) noexcept {
+    }
+    // Размер блока изменён аллокатором: расширен на месте или перевыделен через reallocate
+    static void OnResizeBlock(size_t /*old_bytes*/, size_t /*new_bytes*/, bool /*in_place*/) noexcept {
+    }
+    // Ёмкость вектора изменилась
+    static void OnReallocation() noexcept {
+    }
+    // count элементов создано копированием, bitwise - одним memcpy
+    static void OnCopy(bool /*bitwise*/, size_t /*count*/) noexcept {
+    }
+    // count элементов инициализировано значением, zero_fill - одним memset
+    static void OnValueInit(bool /*zero_fill*/, size_t /*count*/) noexcept {
+    }
+    // count элементов перенесено в новую память способом kind
+    static void OnRelocate(RelocationKind /*kind*/, size_t /*count*/) noexcept {
+    }
+    // count элементов сдвинуто внутри памяти при вставке или удалении
+    static void OnShift(size_t /*count*/) noexcept {
+    }
+    // Размер вектора стал size при ёмкости capacity
+    static void OnSize(size_t /*size*/, size_t /*capacity*/) noexcept {
+    }
+};
+
+template <typename T, typename Alloc = std::allocator<T>, typename Stats = NoVectorStats>
+class RawMemory : private Alloc {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Alloc::value_type must be T");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, T*>,
+                  "Only allocators with raw pointers are supported");
+
 public:
+    using allocator_type = Alloc;
+
+    static constexpr bool CAN_TRY_EXPAND = AllocatorHasTryExpand<Alloc>::value;
+    static constexpr bool CAN_REALLOCATE = AllocatorHasReallocate<Alloc>::value;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    explicit RawMemory(const Alloc& alloc) noexcept
+        : Alloc(alloc) {
+    }
+
+    explicit RawMemory(size_t capacity, const Alloc& alloc = Alloc())
+        : Alloc(alloc)
+        , buffer_(Allocate(capacity))
         , capacity_(capacity) {
     }
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
-    RawMemory(RawMemory&& other) noexcept {
+    RawMemory(RawMemory&& other) noexcept
+        : Alloc(std::move(other.GetAllocatorRef())) {
         buffer_ = std::exchange(other.buffer_, nullptr);
         capacity_ = std::exchange(other.capacity_, 0);
     }
+    // Перемещающее присваивание забирает у rhs и память, и аллокатор
     RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
+            Deallocate(buffer_);
+            GetAllocatorRef() = std::move(rhs.GetAllocatorRef());
             buffer_ = std::exchange(rhs.buffer_, nullptr);
             capacity_ = std::exchange(rhs.capacity_, 0);
         }
@@ -51,7 +304,17 @@ public:
         return buffer_[index];
     }
 
+    // Обменивает память вместе с аллокаторами
     void Swap(RawMemory& other) noexcept {
+        using std::swap;
+        swap(GetAllocatorRef(), other.GetAllocatorRef());
+        std::swap(buffer_, other.buffer_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    // Обменивает только память. Аллокаторы обоих объектов должны быть равны
+    void SwapBuffers(RawMemory& other) noexcept {
+        assert(GetAllocator() == other.GetAllocator());
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
@@ -68,26 +331,373 @@ public:
         return capacity_;
     }
 
+    const Alloc& GetAllocator() const noexcept {
+        return *this;
+    }
+
+    // Пытается увеличить ёмкость, не перемещая блок памяти. Возвращает false, если аллокатор
+    // не поддерживает try_expand или расширить блок на месте не удалось
+    bool TryExpand(size_t new_capacity) noexcept {
+        if constexpr (CAN_TRY_EXPAND) {
+            if (buffer_ != nullptr && GetAllocatorRef().try_expand(buffer_, capacity_, new_capacity)) {
+                Stats::OnResizeBlock(capacity_ * sizeof(T), new_capacity * sizeof(T), true);
+                capacity_ = new_capacity;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Перевыделяет память под new_capacity элементов, перенося содержимое побайтово.
+    // Допустимо только для тривиально перемещаемых элементов. При исключении память не изменяется
+    void Reallocate(size_t new_capacity) {
+        static_assert(CAN_REALLOCATE, "Alloc has no reallocate method");
+        buffer_ = GetAllocatorRef().reallocate(buffer_, capacity_, new_capacity);
+        // Перевыделение пустого буфера для статистики - обычное выделение
+        if (capacity_ == 0) {
+            Stats::OnAllocate(new_capacity * sizeof(T));
+        }
+        else {
+            Stats::OnResizeBlock(capacity_ * sizeof(T), new_capacity * sizeof(T), false);
+        }
+        capacity_ = new_capacity;
+    }
+
 private:
+    Alloc& GetAllocatorRef() noexcept {
+        return *this;
+    }
+
     // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    T* Allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        T* buf = AllocTraits::allocate(GetAllocatorRef(), n);
+        Stats::OnAllocate(n * sizeof(T));
+        return buf;
     }
 
     // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    void Deallocate(T* buf) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(GetAllocatorRef(), buf, capacity_);
+            Stats::OnDeallocate(capacity_ * sizeof(T));
+        }
     }
 
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
+// Блок со stateless-аллокатором - это указатель и ёмкость, поэтому его можно переносить побайтово
+template <typename T, typename Stats>
+struct IsTriviallyRelocatable<RawMemory<T, std::allocator<T>, Stats>> : std::true_type {
+};
+
+// Признак того, что инициализация T значением совпадает с заполнением нулевыми байтами, что позволяет
+// создавать элементы через memset. Нулевой указатель на поддерживаемых платформах состоит из нулей,
+// а указатель на член - нет. Для своих тривиальных типов можно специализировать
+template <typename T>
+struct IsZeroInitializable : std::bool_constant<std::is_scalar_v<T> && !std::is_member_pointer_v<T>> {
+};
+
+template <typename T>
+inline constexpr bool IsZeroInitializableV = IsZeroInitializable<T>::value;
+
+// Копирует n элементов из from в сырую память to. Тривиально копируемые типы копируются одним memcpy
+template <typename T>
+void UninitializedCopyN(const T* from, size_t n, T* to) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (n != 0) {
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+        }
+    }
+    else {
+        std::uninitialized_copy_n(from, n, to);
+    }
+}
+
+// Инициализирует значением n элементов в сырой памяти to. Обнуляемые типы заполняются одним memset
+template <typename T>
+void UninitializedValueConstructN(T* to, size_t n) {
+    if constexpr (IsZeroInitializableV<T>) {
+        if (n != 0) {
+            std::memset(static_cast<void*>(to), 0, n * sizeof(T));
+        }
+    }
+    else {
+        std::uninitialized_value_construct_n(to, n);
+    }
+}
+
+// Конструирует в сырой памяти to n элементов из from. Элементы перемещаются, если этого требует
+// политика Relocation (по умолчанию - если перемещение не выбрасывает исключений или копирование
+// невозможно), иначе копируются. Элементы from не разрушаются
+template <typename Relocation = MoveIfNoexceptRelocation, typename T>
+void UninitializedMoveIfNoexceptN(T* from, size_t n, T* to) {
+    if constexpr (Relocation::template MOVE<T>) {
+        std::uninitialized_move_n(from, n, to);
+    }
+    else {
+        std::uninitialized_copy_n(from, n, to);
+    }
+}
+
+// Переносит n элементов из from в сырую память to, после чего память from не содержит объектов.
+// Тривиально перемещаемые типы переносятся одним memcpy без вызова деструкторов.
+// Если при переносе выброшено исключение, элементы from остаются живыми: при копировании
+// нетронутыми, при перемещении по AlwaysMoveRelocation - возможно, перемещёнными
+template <typename Relocation = MoveIfNoexceptRelocation, typename T>
+void RelocateN(T* from, size_t n, T* to) {
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        if (n != 0) {
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+        }
+    }
+    else {
+        UninitializedMoveIfNoexceptN<Relocation>(from, n, to);
+        std::destroy_n(from, n);
+    }
+}
+
+// Переносит size элементов из from в сырую память to, оставляя в ней промежуток [pos_idx, pos_idx + gap).
+// При исключении элементы from остаются живыми, как в RelocateN, а перенесённые в to элементы разрушаются
+template <typename Relocation = MoveIfNoexceptRelocation, typename T>
+void RelocateWithGap(T* from, size_t size, T* to, size_t pos_idx, size_t gap) {
+    assert(pos_idx <= size);
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        RelocateN(from, pos_idx, to);
+        RelocateN(from + pos_idx, size - pos_idx, to + pos_idx + gap);
+    }
+    else if constexpr (IsNothrowRelocatableV<T, Relocation>) {
+        UninitializedMoveIfNoexceptN<Relocation>(from, pos_idx, to);
+        UninitializedMoveIfNoexceptN<Relocation>(from + pos_idx, size - pos_idx, to + pos_idx + gap);
+        std::destroy_n(from, size);
+    }
+    else {
+        UninitializedMoveIfNoexceptN<Relocation>(from, pos_idx, to);
+        try {
+            UninitializedMoveIfNoexceptN<Relocation>(from + pos_idx, size - pos_idx, to + pos_idx + gap);
+        }
+        catch (...) {
+            std::destroy_n(to, pos_idx);
+            throw;
+        }
+        std::destroy_n(from, size);
+    }
+}
+
+// Конструирует элемент в позиции pos_idx массива data из size элементов, сдвигая хвост вправо.
+// За последним элементом должна быть свободная сырая память под ещё один элемент
+template <typename T, typename... Args>
+void EmplaceWithinCapacity(T* data, size_t size, size_t pos_idx, Args&&... args) {
+    if (size == pos_idx) {
+        new (data + pos_idx) T(std::forward<Args>(args)...);
+    }
+    else
+    {
+        // args могут ссылаться на элементы массива, поэтому элемент создаётся до сдвига
+        auto tmp = T(std::forward<Args>(args)...);
+        new (data + size) T(std::move(data[size - 1]));
+        std::move_backward(data + pos_idx, data + size - 1, data + size);
+        data[pos_idx] = std::move(tmp);
+    }
+}
+
+// Признак того, что operator== для T совпадает с побайтовым сравнением объектов,
+// что позволяет сравнивать векторы через memcmp. Для своих типов можно специализировать
+template <typename T>
+struct IsBitwiseComparable : std::bool_constant<std::is_integral_v<T> || std::is_pointer_v<T>> {
+};
+
+template <typename T>
+inline constexpr bool IsBitwiseComparableV = IsBitwiseComparable<T>::value;
+
+// Ограничивает шаблон типами итераторов (отличает их от целочисленных аргументов)
+template <typename It>
+using RequireInputIterator = std::enable_if_t<
+    std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag>>;
+
+template <typename It>
+inline constexpr bool IsForwardIteratorV =
+    std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
+
+// Стратегии роста ёмкости вектора. NextCapacity<T>(capacity, required) возвращает новую ёмкость
+// не меньше required, когда текущей ёмкости capacity недостаточно для required элементов
+
+// Удваивает ёмкость, начиная с одного элемента
+struct DoublingGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        return std::max(required, capacity == 0 ? size_t{1} : 2 * capacity);
+    }
+};
+
+// Увеличивает ёмкость в Num / Den раз, например FactorGrowth<3, 2> - в полтора раза
+template <size_t Num, size_t Den>
+struct FactorGrowth {
+    static_assert(Num > Den && Den > 0, "Growth factor must be greater than 1");
+
+    template <typename T>
+    static size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        return std::max(required, capacity / Den * Num + capacity % Den * Num / Den);
+    }
+};
+
+// Первое выделение памяти - не меньше MinBytes байт, дальше рост по стратегии Base
+template <typename Base = DoublingGrowth, size_t MinBytes = 64>
+struct MinInitialGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        if (capacity == 0) {
+            return std::max({ required, MinBytes / sizeof(T), size_t{1} });
+        }
+        return Base::template NextCapacity<T>(capacity, required);
+    }
+};
+
+// Округляет размер блока, выбранный стратегией Base, вверх до размерного класса аллокатора:
+// 16 байт, далее по четыре класса на каждую степень двойки (как в jemalloc/tcmalloc),
+// чтобы не терять память, которую аллокатор всё равно выделит
+template <typename Base = DoublingGrowth>
+struct SizeClassGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        const size_t bytes = Base::template NextCapacity<T>(capacity, required) * sizeof(T);
+        return RoundToSizeClass(bytes) / sizeof(T);
+    }
+
+    static size_t RoundToSizeClass(size_t bytes) noexcept {
+        const size_t MIN_CLASS = 16;
+        if (bytes <= MIN_CLASS) {
+            return MIN_CLASS;
+        }
+        size_t pow2 = MIN_CLASS;
+        while (pow2 * 2 < bytes) {
+            pow2 *= 2;
+        }
+        // bytes лежит в (pow2, 2 * pow2], шаг классов в этом диапазоне - pow2 / 4
+        const size_t step = pow2 / 4;
+        return (bytes + step - 1) / step * step;
+    }
+};
+
+// Стратегия роста может также задавать уменьшение ёмкости: Vector вызывает
+// ShrinkCapacity<T>(size, capacity) после удаления элементов и перевыделяет память,
+// если возвращённая ёмкость меньше текущей
+template <typename Growth, typename T, typename = void>
+struct GrowthHasShrinkCapacity : std::false_type {
+};
+
+template <typename Growth, typename T>
+struct GrowthHasShrinkCapacity<Growth, T, std::void_t<decltype(Growth::template ShrinkCapacity<T>(size_t{}, size_t{}))>>
+    : std::true_type {
+};
+
+// Рост по стратегии Base и уменьшение с гистерезисом: когда вектор заполнен не более чем
+// на 1 / Divisor, ёмкость уменьшается до удвоенного размера. Блоки не больше MinBytes не уменьшаются
+template <typename Base = DoublingGrowth, size_t Divisor = 4, size_t MinBytes = 4096>
+struct HysteresisShrink : Base {
+    static_assert(Divisor > 2, "Shrink threshold must leave room for growth");
+
+    template <typename T>
+    static size_t ShrinkCapacity(size_t size, size_t capacity) noexcept {
+        if (capacity * sizeof(T) <= MinBytes || size > capacity / Divisor) {
+            return capacity;
+        }
+        return 2 * size;
+    }
+};
+
+// Тег для создания элементов инициализацией по умолчанию: элементы тривиальных типов
+// остаются неинициализированными, и память не заполняется нулями
+struct DefaultInitTag {
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag DEFAULT_INIT{};
+
+// Признак политики параллельного выполнения для конструкторов и Resize (см. vector_parallel.h).
+// Политика предоставляет метод
+//     template <typename T, typename Body, typename Rollback>
+//     void ForRanges(size_t count, Body body, Rollback rollback) const;
+// который вызывает body(begin, end) для непересекающихся частей [0, count) из разных потоков.
+// Если body бросит исключение, для каждой уже обработанной части вызывается rollback(begin, end),
+// после чего исключение передаётся вызывающему
+template <typename Policy>
+struct IsVectorExecutionPolicy : std::false_type {};
+
+template <typename Policy>
+using RequireExecutionPolicy = std::enable_if_t<IsVectorExecutionPolicy<Policy>::value>;
+
+// Невладеющее представление непрерывного участка элементов: указатель и длина.
+// VectorView<const T> только читает элементы. Представление действительно, пока
+// память, на которую оно указывает, не перевыделена и не освобождена
 template <typename T>
+class VectorView {
+public:
+    using value_type = std::remove_const_t<T>;
+    using iterator = T*;
+
+    VectorView() noexcept = default;
+
+    VectorView(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    // Изменяемое представление приводится к константному
+    template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T>>>
+    VectorView(VectorView<U> other) noexcept
+        : data_(other.Data())
+        , size_(other.Size()) {
+    }
+
+    T* begin() const noexcept {
+        return data_;
+    }
+    T* end() const noexcept {
+        return data_ + size_;
+    }
+
+    T* Data() const noexcept {
+        return data_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Представление count элементов, начиная с pos
+    VectorView Slice(size_t pos, size_t count) const noexcept {
+        assert(pos <= size_ && count <= size_ - pos);
+        return VectorView(data_ + pos, count);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Relocation - политика переноса элементов при реаллокации: MoveIfNoexceptRelocation
+// (строгая гарантия) или AlwaysMoveRelocation (базовая гарантия без копирования элементов)
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth,
+          typename Stats = NoVectorStats, typename Relocation = MoveIfNoexceptRelocation>
 class Vector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Memory = RawMemory<T, Alloc, Stats>;
+
 public:
+    using value_type = T;
     using iterator = T*;
     using const_iterator = const T*;
+    using allocator_type = Alloc;
 
     iterator begin() noexcept {
         return data_.GetAddress();
@@ -110,11 +720,58 @@ public:
 
     Vector() = default;
 
-    explicit Vector(size_t size)
-        : data_(size)
+    explicit Vector(const Alloc& alloc) noexcept
+        : data_(alloc) {
+    }
+
+    explicit Vector(size_t size, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+        , size_(size)  //
+    {
+        UninitializedValueConstructN(data_.GetAddress(), size);
+        Stats::OnValueInit(IsZeroInitializableV<T>, size);
+        Stats::OnSize(size_, data_.Capacity());
+    }
+
+    Vector(size_t size, DefaultInitTag, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
         , size_(size)  //
     {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+        std::uninitialized_default_construct_n(data_.GetAddress(), size);
+        Stats::OnSize(size_, data_.Capacity());
+    }
+
+    // Параллельные конструкторы: каждую часть буфера впервые записывает поток, заполняющий её,
+    // поэтому на NUMA-системах страницы распределяются по узлам этих потоков (first touch)
+    template <typename Policy, typename = RequireExecutionPolicy<Policy>>
+    Vector(size_t size, const Policy& policy, const Alloc& alloc = Alloc())
+        : data_(size, alloc) {
+        ConstructInParallel(0, size, policy, [this](size_t first, size_t last) {
+            UninitializedValueConstructN(data_.GetAddress() + first, last - first);
+        });
+        Stats::OnValueInit(IsZeroInitializableV<T>, size);
+        size_ = size;
+        Stats::OnSize(size_, data_.Capacity());
+    }
+
+    // Элемент с индексом i создаётся из generator(i). Генератор вызывается одновременно из разных потоков
+    template <typename Generator, typename Policy, typename = RequireExecutionPolicy<Policy>,
+              typename = std::enable_if_t<std::is_invocable_v<Generator&, size_t>>>
+    Vector(size_t size, Generator generator, const Policy& policy, const Alloc& alloc = Alloc())
+        : data_(size, alloc) {
+        ConstructInParallel(0, size, policy, [this, &generator](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                try {
+                    new (data_ + i) T(generator(i));
+                }
+                catch (...) {
+                    std::destroy(data_ + first, data_ + i);
+                    throw;
+                }
+            }
+        });
+        size_ = size;
+        Stats::OnSize(size_, data_.Capacity());
     }
 
     ~Vector() {
@@ -123,85 +780,243 @@ public:
         }
     }
 
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    Vector(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : Vector(alloc)  // делегирование гарантирует разрушение элементов при исключении
+    {
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            Reserve(std::distance(first, last));
+        }
+        Append(first, last);
+    }
+
+    Vector(std::initializer_list<T> init, const Alloc& alloc = Alloc())
+        : Vector(init.begin(), init.end(), alloc) {
+    }
+
     Vector(const Vector& other)
-        : data_(other.size_)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    Vector(const Vector& other, const Alloc& alloc)
+        : data_(other.size_, alloc)
         , size_(other.size_)  //
     {
-        // constexpr оператор if будет вычислен во время компиляции
-        UninitializedData(other.data_, data_);
+        UninitializedCopyN(other.data_.GetAddress(), size_, data_.GetAddress());
+        Stats::OnCopy(std::is_trivially_copyable_v<T>, size_);
+        Stats::OnSize(size_, data_.Capacity());
+    }
+
+    // Копирует элементы представления, выделяя память один раз
+    explicit Vector(VectorView<const T> view, const Alloc& alloc = Alloc())
+        : data_(view.Size(), alloc)
+        , size_(view.Size())  //
+    {
+        UninitializedCopyN(view.Data(), size_, data_.GetAddress());
+        Stats::OnCopy(std::is_trivially_copyable_v<T>, size_);
+        Stats::OnSize(size_, data_.Capacity());
     }
 
     Vector(Vector&& other) noexcept
-        : data_(std::exchange(other.data_, RawMemory<T>()))
+        : data_(std::move(other.data_))
         , size_(std::exchange(other.size_, 0)) {
     }
 
+    // Если аллокаторы не равны, память other не может быть передана, и элементы перемещаются поштучно
+    Vector(Vector&& other, const Alloc& alloc)
+        : data_(alloc) {
+        if (alloc == other.GetAllocator()) {
+            data_.SwapBuffers(other.data_);
+            size_ = std::exchange(other.size_, 0);
+        }
+        else {
+            Memory new_data(other.size_, alloc);
+            std::uninitialized_move_n(other.begin(), other.size_, new_data.GetAddress());
+            data_.SwapBuffers(new_data);
+            size_ = other.size_;
+        }
+    }
+
     Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Текущую память можно освободить только старым аллокатором,
+                    // поэтому копия строится аллокатором rhs и обменивается целиком
+                    Vector rhs_copy(rhs, rhs.GetAllocator());
+                    SwapWithAllocator(rhs_copy);
+                    return *this;
+                }
+            }
             if (rhs.size_ > data_.Capacity()) {
                 /* Применить copy-and-swap */
-                Vector rhs_copy(rhs);
+                Vector rhs_copy(rhs, GetAllocator());
                 Swap(rhs_copy);
             }
+            else if constexpr (std::is_trivially_copyable_v<T>) {
+                // Присваивание и создание тривиально копируемых элементов - одно и то же копирование байтов
+                UninitializedCopyN(rhs.data_.GetAddress(), rhs.size_, data_.GetAddress());
+                Stats::OnCopy(true, rhs.size_);
+                size_ = rhs.size_;
+            }
             else {
                 /* Скопировать элементы из rhs, создав при необходимости новые или удалив существующие */
-                //size_t count = std::abs(rhs.size_ - size_);
-                size_t count = (rhs.size_ < size_) ? size_ - rhs.size_ : rhs.size_ - size_;                
                 if (rhs.size_ < size_) {
-					std::copy_n(rhs.data_.GetAddress(), rhs.size_, begin());
-                    std::destroy_n(data_.GetAddress() + rhs.size_, count);
+                    std::copy_n(rhs.data_.GetAddress(), rhs.size_, begin());
+                    std::destroy_n(data_.GetAddress() + rhs.size_, size_ - rhs.size_);
                 }
                 else {
                     std::copy_n(rhs.data_.GetAddress(), size_, begin());
-                    std::uninitialized_copy_n(rhs.data_.GetAddress() + size_, count, data_.GetAddress() + size_);
+                    UninitializedCopyN(rhs.data_.GetAddress() + size_, rhs.size_ - size_, data_.GetAddress() + size_);
                 }
+                Stats::OnCopy(false, rhs.size_);
                 size_ = rhs.size_;
             }
         }
         return *this;
     }
-    Vector& operator=(Vector&& rhs) noexcept {
+    Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value) {
         if (this != &rhs) {
-            data_ = std::exchange(rhs.data_, RawMemory<T>());
-            size_ = std::exchange(rhs.size_, 0);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                std::destroy_n(data_.GetAddress(), size_);
+                data_ = std::move(rhs.data_);
+                size_ = std::exchange(rhs.size_, 0);
+            }
+            else if (GetAllocator() == rhs.GetAllocator()) {
+                std::destroy_n(data_.GetAddress(), size_);
+                // Старая память освобождается вместе с rhs_data
+                Memory rhs_data(GetAllocator());
+                rhs_data.SwapBuffers(rhs.data_);
+                data_.SwapBuffers(rhs_data);
+                size_ = std::exchange(rhs.size_, 0);
+            }
+            else {
+                // Аллокаторы не равны и не распространяются: память rhs забрать нельзя
+                MoveAssignElements(rhs);
+            }
         }
         return *this;
     }
 
+    // Аллокаторы обмениваются, только если этого требует propagate_on_container_swap,
+    // иначе они должны быть равны
     void Swap(Vector& other) noexcept {
-        std::swap(data_, other.data_);
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            data_.Swap(other.data_);
+        }
+        else {
+            data_.SwapBuffers(other.data_);
+        }
         std::swap(size_, other.size_);
     }
 
+    const Alloc& GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
     void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
-        // Конструируем элементы в new_data, копируя их из data_
-        // constexpr оператор if будет вычислен во время компиляции        
-        UninitializedNewData(new_data);
-
-        // Разрушаем элементы в data_
-        std::destroy_n(data_.GetAddress(), size_);
-        // Избавляемся от старой сырой памяти, обменивая её на новую
-        data_.Swap(new_data);
-        // При выходе из метода старая память будет возвращена в кучу
+        if (!TryGrowInPlace(new_capacity)) {
+            Memory new_data(new_capacity, GetAllocator());
+            // Переносим элементы в new_data, элементы в data_ после этого разрушены
+            RelocateN<Relocation>(data_.GetAddress(), size_, new_data.GetAddress());
+            Stats::OnReallocation();
+            Stats::OnRelocate(GetRelocationKind<T, Relocation>(), size_);
+            // Избавляемся от старой сырой памяти, обменивая её на новую
+            data_.Swap(new_data);
+            // При выходе из блока старая память будет возвращена в кучу
+        }
+        Stats::OnSize(size_, data_.Capacity());
     }
 
     void Resize(size_t new_size) {
-        if (new_size > data_.Capacity()) {
+        if (new_size > size_) {
             Reserve(new_size);
-            std::uninitialized_value_construct_n(data_.GetAddress(), new_size - size_);
+            UninitializedValueConstructN(data_.GetAddress() + size_, new_size - size_);
+            Stats::OnValueInit(IsZeroInitializableV<T>, new_size - size_);
         }
-        else
-        {
+        else {
             std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
         }
         size_ = new_size;
+        Stats::OnSize(size_, data_.Capacity());
+        MaybeShrink();
     }
 
-    void PushBack(const T& value) {
+    // Как Resize, но новые элементы создаются параллельно политикой policy
+    template <typename Policy, typename = RequireExecutionPolicy<Policy>>
+    void Resize(size_t new_size, const Policy& policy) {
+        if (new_size <= size_) {
+            Resize(new_size);
+            return;
+        }
+        Reserve(new_size);
+        ConstructInParallel(size_, new_size - size_, policy, [this](size_t first, size_t last) {
+            UninitializedValueConstructN(data_.GetAddress() + first, last - first);
+        });
+        Stats::OnValueInit(IsZeroInitializableV<T>, new_size - size_);
+        size_ = new_size;
+        Stats::OnSize(size_, data_.Capacity());
+    }
+
+    // Как Resize, но новые элементы инициализируются по умолчанию, а не значением
+    void ResizeDefaultInit(size_t new_size) {
+        if (new_size > size_) {
+            Reserve(new_size);
+            std::uninitialized_default_construct_n(data_.GetAddress() + size_, new_size - size_);
+        }
+        else {
+            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+        }
+        size_ = new_size;
+        Stats::OnSize(size_, data_.Capacity());
+        MaybeShrink();
+    }
+
+    // Разрушает все элементы, сохраняя ёмкость
+    void Clear() noexcept {
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+    // Разрушает все элементы и освобождает память
+    void ClearAndRelease() noexcept {
+        Clear();
+        Memory empty(GetAllocator());
+        data_.Swap(empty);
+    }
+
+    // Уменьшает ёмкость до размера, перенося элементы так же, как Reserve
+    void ShrinkToFit() {
+        if (data_.Capacity() > size_) {
+            ShrinkTo(size_);
+        }
+    }
+
+    // Увеличивает (или уменьшает) вектор до new_size элементов, инициализируя новые по умолчанию,
+    // и передаёт их на заполнение операции op(T* data, size_t new_size). Операция возвращает
+    // итоговый размер не больше new_size, лишние элементы в конце разрушаются.
+    // Если op выбросит исключение, новые элементы разрушаются
+    template <typename Operation>
+    void ResizeAndOverwrite(size_t new_size, Operation op) {
+        const size_t kept_size = std::min(size_, new_size);
+        ResizeDefaultInit(new_size);
+        size_t final_size = 0;
+        try {
+            final_size = std::move(op)(data_.GetAddress(), new_size);
+        }
+        catch (...) {
+            ResizeDefaultInit(kept_size);
+            throw;
+        }
+        assert(final_size <= new_size);
+        ResizeDefaultInit(final_size);
+    }
+
+    void PushBack(const T& value) {
         EmplaceBack(value);
     }
 
@@ -212,12 +1027,21 @@ public:
     void PopBack() noexcept {
         std::destroy_n(data_.GetAddress() + size_ - 1, 1);
         --size_;
+        MaybeShrink();
     }
 
     template <typename... Args>
     T& EmplaceBack(Args&&... args) {
-        
-        return *Emplace(end(), std::forward<Args>(args)...);
+        if (size_ < data_.Capacity()) {
+            // Сдвигать нечего, элемент конструируется сразу в конце
+            new (data_ + size_) T(std::forward<Args>(args)...);
+        }
+        else {
+            InsertWithAlloc(size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+        Stats::OnSize(size_, data_.Capacity());
+        return data_[size_ - 1];
     }
 
     iterator Insert(const_iterator pos, const T& value) {
@@ -228,13 +1052,62 @@ public:
         return Emplace(pos, std::move(value));
     }
 
+    // Вставляет count копий value. value может быть элементом этого же вектора
+    iterator Insert(const_iterator pos, size_t count, const T& value) {
+        const size_t pos_idx = std::distance(cbegin(), pos);
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            // Сдвиг хвоста memmove переместил бы value, если он лежит в векторе
+            if (std::less_equal<const T*>()(cbegin(), &value) && std::less<const T*>()(&value, cend())) {
+                const T value_copy(value);
+                return InsertN(pos_idx, count, [&](T* dst) {
+                    std::uninitialized_fill_n(dst, count, value_copy);
+                });
+            }
+        }
+        return InsertN(pos_idx, count, [&](T* dst) {
+            std::uninitialized_fill_n(dst, count, value);
+        });
+    }
+
+    // Вставляет элементы диапазона [first, last), который не должен ссылаться на элементы этого вектора.
+    // Для прямых итераторов память выделяется не более одного раза, а хвост сдвигается один раз
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        const size_t pos_idx = std::distance(cbegin(), pos);
+        if constexpr (IsForwardIteratorV<InputIt>) {
+            const size_t count = std::distance(first, last);
+            return InsertN(pos_idx, count, [&](T* dst) {
+                std::uninitialized_copy(first, last, dst);
+            });
+        }
+        else {
+            // Размер диапазона заранее неизвестен: элементы добавляются в конец и затем
+            // переставляются на место за один проход
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(begin() + pos_idx, begin() + old_size, end());
+            return begin() + pos_idx;
+        }
+    }
+
+    iterator Insert(const_iterator pos, std::initializer_list<T> init) {
+        return Insert(pos, init.begin(), init.end());
+    }
+
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
+
     template <typename... Args>
     iterator Emplace(const_iterator pos, Args&&... args) {
 
         size_t pos_idx = std::distance(cbegin(), pos);
 
         if (size_ == Capacity()) {
-            InsertWithAlloc(pos, pos_idx, std::forward<Args>(args)...);
+            InsertWithAlloc(pos_idx, std::forward<Args>(args)...);
         }
         else 
         {   //size < capacity
@@ -242,17 +1115,95 @@ public:
         }
 
         ++size_;
+        Stats::OnSize(size_, data_.Capacity());
         return begin() + pos_idx;
     }
 
     iterator Erase(const_iterator pos) {
-        size_t pos_idx = std::distance(cbegin(), pos);
-        std::move(begin() + pos_idx + 1, end(), begin() + pos_idx);
-        std::destroy_n(end() - 1, 1);
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last), сдвигая хвост один раз
+    iterator Erase(const_iterator first, const_iterator last) {
+        const size_t first_idx = std::distance(cbegin(), first);
+        const size_t count = std::distance(first, last);
+        T* pos = begin() + first_idx;
+        Stats::OnShift(size_ - first_idx - count);
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            std::destroy_n(pos, count);
+            std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count),
+                         (size_ - first_idx - count) * sizeof(T));
+        }
+        else {
+            std::move(pos + count, end(), pos);
+            std::destroy_n(end() - count, count);
+        }
+        size_ -= count;
+        MaybeShrink();
+        return begin() + first_idx;
+    }
+
+    // Удаляет элемент за O(1), перемещая на его место последний. Порядок элементов не сохраняется
+    iterator SwapErase(const_iterator pos) {
+        const size_t pos_idx = std::distance(cbegin(), pos);
+        T* hole = begin() + pos_idx;
+        T* last = end() - 1;
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            std::destroy_at(hole);
+            if (hole != last) {
+                std::memcpy(static_cast<void*>(hole), static_cast<const void*>(last), sizeof(T));
+            }
+        }
+        else {
+            if (hole != last) {
+                *hole = std::move(*last);
+            }
+            std::destroy_at(last);
+        }
+        Stats::OnShift(hole != last ? 1 : 0);
         --size_;
+        MaybeShrink();
         return begin() + pos_idx;
     }
 
+    // Удаляет все элементы, для которых pred возвращает true, за один проход.
+    // Возвращает количество удалённых элементов
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred) {
+        const size_t old_size = size_;
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            // Оставшиеся элементы переносятся на освободившиеся места побайтово
+            T* out = begin();
+            T* it = begin();
+            try {
+                for (; it != end(); ++it) {
+                    if (pred(*it)) {
+                        std::destroy_at(it);
+                    }
+                    else {
+                        if (out != it) {
+                            std::memcpy(static_cast<void*>(out), static_cast<const void*>(it), sizeof(T));
+                        }
+                        ++out;
+                    }
+                }
+            }
+            catch (...) {
+                // Непросмотренные элементы сохраняются, закрывая образовавшиеся дыры
+                const size_t rest = end() - it;
+                std::memmove(static_cast<void*>(out), static_cast<const void*>(it), rest * sizeof(T));
+                size_ = (out - begin()) + rest;
+                throw;
+            }
+            size_ = out - begin();
+            MaybeShrink();
+        }
+        else {
+            Erase(std::remove_if(begin(), end(), pred), end());
+        }
+        return old_size - size_;
+    }
+
     size_t Size() const noexcept {
         return size_;
     }
@@ -261,6 +1212,12 @@ public:
         return data_.Capacity();
     }
 
+    // Наибольшее число элементов: столько помещается в объект размером не больше PTRDIFF_MAX байт
+    size_t MaxSize() const noexcept {
+        return std::min<size_t>(AllocTraits::max_size(GetAllocator()),
+                                std::numeric_limits<std::ptrdiff_t>::max() / sizeof(T));
+    }
+
     const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
@@ -270,96 +1227,909 @@ public:
         return data_[index];
     }
 
+    T* Data() noexcept {
+        return data_.GetAddress();
+    }
+
+    const T* Data() const noexcept {
+        return data_.GetAddress();
+    }
+
+    // Представления элементов недействительны после реаллокации и удаления элементов
+    VectorView<T> AsView() noexcept {
+        return VectorView<T>(Data(), size_);
+    }
+
+    VectorView<const T> AsView() const noexcept {
+        return VectorView<const T>(Data(), size_);
+    }
+
+    VectorView<T> Slice(size_t pos, size_t count) noexcept {
+        return AsView().Slice(pos, count);
+    }
+
+    VectorView<const T> Slice(size_t pos, size_t count) const noexcept {
+        return AsView().Slice(pos, count);
+    }
+
 private:
-    // Вызывает деструкторы n объектов массива по адресу buf
-    static void DestroyN(T * buf, size_t n) noexcept {
-        for (size_t i = 0; i != n; ++i) {
-            Destroy(buf + i);
-        }
+    // Параллельно создаёт элементы [first, first + count) в выделенной памяти. construct(begin, end)
+    // создаёт элементы этого диапазона индексов и при исключении разрушает уже созданные
+    template <typename Policy, typename Construct>
+    void ConstructInParallel(size_t first, size_t count, const Policy& policy, Construct construct) {
+        policy.template ForRanges<T>(
+            count,
+            [first, &construct](size_t begin, size_t end) {
+                construct(first + begin, first + end);
+            },
+            [this, first](size_t begin, size_t end) noexcept {
+                std::destroy(data_ + first + begin, data_ + first + end);
+            });
     }
 
-    // Создаёт копию объекта elem в сырой памяти по адресу buf
-    static void CopyConstruct(T * buf, const T & elem) {
-        new (buf) T(elem);
+    // Обменивает содержимое вместе с аллокаторами независимо от propagate_on_container_swap
+    void SwapWithAllocator(Vector& other) noexcept {
+        data_.Swap(other.data_);
+        std::swap(size_, other.size_);
     }
 
-    // Вызывает деструктор объекта по адресу buf
-    static void Destroy(T * buf) noexcept {
-        buf->~T();
+    // Поэлементное перемещающее присваивание для случая неравных аллокаторов
+    void MoveAssignElements(Vector& rhs) {
+        if (rhs.size_ > data_.Capacity()) {
+            Vector rhs_moved(std::move(rhs), GetAllocator());
+            Swap(rhs_moved);
+        }
+        else {
+            if (rhs.size_ < size_) {
+                std::move(rhs.begin(), rhs.end(), begin());
+                std::destroy_n(data_.GetAddress() + rhs.size_, size_ - rhs.size_);
+            }
+            else {
+                std::move(rhs.begin(), rhs.begin() + size_, begin());
+                std::uninitialized_move_n(rhs.begin() + size_, rhs.size_ - size_, data_.GetAddress() + size_);
+            }
+            size_ = rhs.size_;
+        }
     }
 
-    void UninitializedData(const RawMemory<T>& from, RawMemory<T>& to) {
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(from.GetAddress(), size_, to.GetAddress());
+    // Вставляет count элементов в позицию pos_idx. construct(T* dst) конструирует их в сырой
+    // памяти dst и при исключении сам разрушает уже созданные. Память выделяется не более одного раза
+    template <typename ConstructFn>
+    iterator InsertN(size_t pos_idx, size_t count, ConstructFn construct) {
+        if (count == 0) {
+            return begin() + pos_idx;
+        }
+        if (size_ + count > data_.Capacity()) {
+            const size_t new_capacity = Growth::template NextCapacity<T>(data_.Capacity(), GrownSize(count));
+            if (!data_.TryExpand(new_capacity)) {
+                Memory new_data(new_capacity, GetAllocator());
+                // Новые элементы конструируются до переноса старых, пока исходные данные доступны
+                construct(new_data.GetAddress() + pos_idx);
+                if constexpr (IsNothrowRelocatableV<T, Relocation>) {
+                    RelocateWithGap<Relocation>(data_.GetAddress(), size_, new_data.GetAddress(), pos_idx, count);
+                }
+                else {
+                    try {
+                        RelocateWithGap<Relocation>(data_.GetAddress(), size_, new_data.GetAddress(), pos_idx, count);
+                    }
+                    catch (...) {
+                        std::destroy_n(new_data.GetAddress() + pos_idx, count);
+                        throw;
+                    }
+                }
+                Stats::OnReallocation();
+                Stats::OnRelocate(GetRelocationKind<T, Relocation>(), size_);
+                data_.Swap(new_data);
+                size_ += count;
+                Stats::OnSize(size_, data_.Capacity());
+                return begin() + pos_idx;
+            }
+            Stats::OnReallocation();
+        }
+        T* pos = begin() + pos_idx;
+        Stats::OnShift(size_ - pos_idx);
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            // Хвост переносится одним memmove, освобождая место под новые элементы
+            const size_t tail_bytes = (size_ - pos_idx) * sizeof(T);
+            std::memmove(static_cast<void*>(pos + count), static_cast<const void*>(pos), tail_bytes);
+            try {
+                construct(pos);
+            }
+            catch (...) {
+                std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count), tail_bytes);
+                throw;
+            }
         }
         else {
-            std::uninitialized_copy_n(from.GetAddress(), size_, to.GetAddress());
+            // Новые элементы создаются в конце и переставляются на место одним поворотом.
+            // Если поворот выбросит исключение, последние count элементов разрушаются,
+            // а в векторе остаются size_ живых элементов в неопределённом порядке
+            construct(end());
+            try {
+                std::rotate(pos, end(), end() + count);
+            }
+            catch (...) {
+                std::destroy_n(end(), count);
+                throw;
+            }
         }
+        size_ += count;
+        Stats::OnSize(size_, data_.Capacity());
+        return begin() + pos_idx;
     }
-    void UninitializedNewData(RawMemory<T>& new_data) {
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+
+    // Перевыделяет память под new_capacity >= size_ элементов, меньше текущей ёмкости
+    void ShrinkTo(size_t new_capacity) {
+        assert(size_ <= new_capacity && new_capacity < data_.Capacity());
+        Stats::OnReallocation();
+        if (new_capacity == 0) {
+            Memory empty(GetAllocator());
+            data_.Swap(empty);
+            return;
+        }
+        if constexpr (IsTriviallyRelocatableV<T> && Memory::CAN_REALLOCATE) {
+            data_.Reallocate(new_capacity);
+            Stats::OnRelocate(RelocationKind::BITWISE, size_);
         }
         else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+            Memory new_data(new_capacity, GetAllocator());
+            RelocateN<Relocation>(data_.GetAddress(), size_, new_data.GetAddress());
+            Stats::OnRelocate(GetRelocationKind<T, Relocation>(), size_);
+            data_.Swap(new_data);
+        }
+    }
+
+    // Уменьшает ёмкость, если этого требует стратегия роста. Уменьшение необязательно,
+    // поэтому неудача при выделении памяти или копировании элементов игнорируется
+    void MaybeShrink() noexcept {
+        if constexpr (GrowthHasShrinkCapacity<Growth, T>::value) {
+            const size_t new_capacity = Growth::template ShrinkCapacity<T>(size_, data_.Capacity());
+            if (new_capacity < data_.Capacity()) {
+                try {
+                    ShrinkTo(std::max(new_capacity, size_));
+                }
+                catch (...) {
+                }
+            }
         }
     }
 
     template <typename... Args>
     void InsertWithoutAlloc(size_t pos_idx, Args&&... args) {
-        if (size_ == pos_idx) {
-            new (begin() + pos_idx) T(std::forward<Args>(args)...);
+        Stats::OnShift(size_ - pos_idx);
+        EmplaceWithinCapacity(data_.GetAddress(), size_, pos_idx, std::forward<Args>(args)...);
+    }
+
+    // Пытается увеличить ёмкость без поэлементного переноса: расширением блока на месте
+    // или, для тривиально перемещаемых типов, через reallocate аллокатора
+    bool TryGrowInPlace(size_t new_capacity) {
+        if (data_.TryExpand(new_capacity)) {
+            Stats::OnReallocation();
+            return true;
         }
-        else
-        {
-            auto tmp = T(std::forward<Args>(args)...);
-            new (end()) T(std::forward<T>(*(end() - 1)));
-            std::move_backward(begin() + pos_idx, end() - 1, end());
-            data_[pos_idx] = std::move(tmp);
+        if constexpr (IsTriviallyRelocatableV<T> && Memory::CAN_REALLOCATE) {
+            data_.Reallocate(new_capacity);
+            Stats::OnReallocation();
+            Stats::OnRelocate(RelocationKind::BITWISE, size_);
+            return true;
         }
+        return false;
     }
 
-    template <typename... Args>
-    void InsertWithAlloc(const_iterator pos, size_t pos_idx, Args&&... args) {
-        size_t count_prev = std::distance(cbegin(), pos);
-        size_t count_next = std::distance(pos, cend());
+    // Размер после добавления count элементов. Если он больше MaxSize(), выбрасывает std::length_error
+    size_t GrownSize(size_t count) const {
+        if (count > MaxSize() || size_ > MaxSize() - count) {
+            throw std::length_error("Vector size exceeds MaxSize()");
+        }
+        return size_ + count;
+    }
 
-        RawMemory<T> new_data((size_ == 0) ? 1 : 2 * size_);
-        new (new_data.GetAddress() + pos_idx) T(std::forward<Args>(args)...);
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+    template <typename... Args>
+    void InsertWithAlloc(size_t pos_idx, Args&&... args) {
+        const size_t new_capacity = Growth::template NextCapacity<T>(data_.Capacity(), GrownSize(1));
+        if (data_.TryExpand(new_capacity)) {
+            Stats::OnReallocation();
+            // Блок расширен на месте, адреса элементов (и ссылки в args) остались прежними
+            InsertWithoutAlloc(pos_idx, std::forward<Args>(args)...);
+            return;
+        }
+        if constexpr (IsTriviallyRelocatableV<T> && Memory::CAN_REALLOCATE) {
+            // reallocate может переместить блок, а args - ссылаться на элементы вектора,
+            // поэтому новый элемент конструируется заранее и затем переносится побайтово
+            alignas(T) unsigned char elem_buf[sizeof(T)];
+            T* elem = new (elem_buf) T(std::forward<Args>(args)...);
             try {
-                std::uninitialized_move_n(begin(), count_prev, new_data.GetAddress());
+                data_.Reallocate(new_capacity);
             }
             catch (...) {
-                std::destroy_n(begin(), count_prev);
+                std::destroy_at(elem);
+                throw;
             }
+            Stats::OnReallocation();
+            Stats::OnRelocate(RelocationKind::BITWISE, size_);
+            Stats::OnShift(size_ - pos_idx);
+            T* pos = begin() + pos_idx;
+            std::memmove(static_cast<void*>(pos + 1), static_cast<const void*>(pos), (size_ - pos_idx) * sizeof(T));
+            std::memcpy(static_cast<void*>(pos), static_cast<const void*>(elem), sizeof(T));
+        }
+        else {
+            InsertWithRelocation(new_capacity, pos_idx, std::forward<Args>(args)...);
+        }
+    }
+
+    template <typename... Args>
+    void InsertWithRelocation(size_t new_capacity, size_t pos_idx, Args&&... args) {
+        Memory new_data(new_capacity, GetAllocator());
+        // Новый элемент конструируется до переноса, так как args могут ссылаться на элементы вектора
+        T* new_elem = new (new_data + pos_idx) T(std::forward<Args>(args)...);
+        if constexpr (IsNothrowRelocatableV<T, Relocation>) {
+            RelocateWithGap<Relocation>(data_.GetAddress(), size_, new_data.GetAddress(), pos_idx, 1);
+        }
+        else {
             try {
-                std::uninitialized_move_n(begin() + count_prev, count_next, new_data.GetAddress() + count_prev + 1);
+                RelocateWithGap<Relocation>(data_.GetAddress(), size_, new_data.GetAddress(), pos_idx, 1);
             }
             catch (...) {
-                std::destroy_n(begin() + count_prev, count_next);
+                // new_data освобождается деструктором, элементы data_ остаются на месте
+                std::destroy_at(new_elem);
+                throw;
             }
         }
-        else
-        {
-            try {
-                std::uninitialized_copy_n(begin(), count_prev, new_data.GetAddress());
+        Stats::OnReallocation();
+        Stats::OnRelocate(GetRelocationKind<T, Relocation>(), size_);
+        data_.Swap(new_data);
+    }
+
+    Memory data_;
+    size_t size_ = 0;
+};
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+bool operator==(const Vector<T, Alloc, Growth, Stats, Relocation>& lhs, const Vector<T, Alloc, Growth, Stats, Relocation>& rhs) {
+    if (lhs.Size() != rhs.Size()) {
+        return false;
+    }
+    if constexpr (IsBitwiseComparableV<T>) {
+        return lhs.Size() == 0 || std::memcmp(lhs.begin(), rhs.begin(), lhs.Size() * sizeof(T)) == 0;
+    }
+    else {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+bool operator!=(const Vector<T, Alloc, Growth, Stats, Relocation>& lhs, const Vector<T, Alloc, Growth, Stats, Relocation>& rhs) {
+    return !(lhs == rhs);
+}
+
+// Лексикографическое сравнение. Для однобайтовых беззнаковых типов порядок байтов совпадает
+// с порядком элементов, поэтому общий префикс сравнивается через memcmp
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+bool operator<(const Vector<T, Alloc, Growth, Stats, Relocation>& lhs, const Vector<T, Alloc, Growth, Stats, Relocation>& rhs) {
+    if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == 1) {
+        const size_t common = std::min(lhs.Size(), rhs.Size());
+        const int cmp = common == 0 ? 0 : std::memcmp(lhs.begin(), rhs.begin(), common);
+        return cmp < 0 || (cmp == 0 && lhs.Size() < rhs.Size());
+    }
+    else {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+bool operator>(const Vector<T, Alloc, Growth, Stats, Relocation>& lhs, const Vector<T, Alloc, Growth, Stats, Relocation>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+bool operator<=(const Vector<T, Alloc, Growth, Stats, Relocation>& lhs, const Vector<T, Alloc, Growth, Stats, Relocation>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+bool operator>=(const Vector<T, Alloc, Growth, Stats, Relocation>& lhs, const Vector<T, Alloc, Growth, Stats, Relocation>& rhs) {
+    return !(lhs < rhs);
+}
+
+// Вектор, буфер которого выровнен по Alignment байт
+template <typename T, size_t Alignment = 64, typename Growth = DoublingGrowth>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>, Growth>;
+
+// Размер блока StableVector по умолчанию: наибольшая степень двойки, при которой блок
+// не больше 4 КиБ, но не меньше 16 элементов
+template <typename T>
+constexpr size_t DefaultStableChunkSize() noexcept {
+    size_t size = 16;
+    while (size * 2 * sizeof(T) <= 4096) {
+        size *= 2;
+    }
+    return size;
+}
+
+// Сегментированный вектор: элементы хранятся в блоках RawMemory по ChunkSize элементов, адреса
+// которых собраны в небольшом каталоге. Рост добавляет блок и никогда не переносит элементы,
+// поэтому ссылки, указатели и итераторы остаются действительными до удаления элемента,
+// а добавление в худшем случае стоит одного выделения блока. Каталог при росте копирует только
+// указатели на блоки (один на ChunkSize элементов), Reserve устраняет и это.
+// operator[] выполняется за O(1): номер блока и смещение получаются сдвигом и маской
+template <typename T, typename Alloc = std::allocator<T>, size_t ChunkSize = DefaultStableChunkSize<T>()>
+class StableVector {
+    static_assert(ChunkSize != 0 && (ChunkSize & (ChunkSize - 1)) == 0, "Chunk size must be a power of two");
+
+    using Chunk = RawMemory<T, Alloc>;
+    using ChunkAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Chunk>;
+
+    static constexpr size_t ChunkShift() noexcept {
+        size_t shift = 0;
+        while ((size_t{ 1 } << shift) != ChunkSize) {
+            ++shift;
+        }
+        return shift;
+    }
+
+    static constexpr size_t CHUNK_SHIFT = ChunkShift();
+    static constexpr size_t CHUNK_MASK = ChunkSize - 1;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    static constexpr size_t CHUNK_SIZE = ChunkSize;
+
+    // Итератор хранит индекс, поэтому добавление элементов его не инвалидирует
+    template <bool IS_CONST>
+    class Iterator {
+        using Owner = std::conditional_t<IS_CONST, const StableVector, StableVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IS_CONST, const T&, T&>;
+        using pointer = std::conditional_t<IS_CONST, const T*, T*>;
+
+        Iterator() = default;
+
+        Iterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        // Неконстантный итератор преобразуется в константный
+        template <bool OTHER_CONST, typename = std::enable_if_t<IS_CONST && !OTHER_CONST>>
+        Iterator(const Iterator<OTHER_CONST>& other) noexcept
+            : owner_(other.owner_)
+            , index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+        pointer operator->() const noexcept {
+            return &(*owner_)[index_];
+        }
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        size_t Index() const noexcept {
+            return index_;
+        }
+
+        Iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+        Iterator operator++(int) noexcept {
+            Iterator old = *this;
+            ++index_;
+            return old;
+        }
+        Iterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+        Iterator operator--(int) noexcept {
+            Iterator old = *this;
+            --index_;
+            return old;
+        }
+        Iterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+        Iterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+        Iterator operator+(difference_type offset) const noexcept {
+            return Iterator(owner_, index_ + offset);
+        }
+        friend Iterator operator+(difference_type offset, const Iterator& it) noexcept {
+            return it + offset;
+        }
+        Iterator operator-(difference_type offset) const noexcept {
+            return Iterator(owner_, index_ - offset);
+        }
+        difference_type operator-(const Iterator& other) const noexcept {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        bool operator==(const Iterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+        bool operator!=(const Iterator& other) const noexcept {
+            return index_ != other.index_;
+        }
+        bool operator<(const Iterator& other) const noexcept {
+            return index_ < other.index_;
+        }
+        bool operator>(const Iterator& other) const noexcept {
+            return index_ > other.index_;
+        }
+        bool operator<=(const Iterator& other) const noexcept {
+            return index_ <= other.index_;
+        }
+        bool operator>=(const Iterator& other) const noexcept {
+            return index_ >= other.index_;
+        }
+
+    private:
+        friend class Iterator<!IS_CONST>;
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    StableVector() = default;
+
+    explicit StableVector(const Alloc& alloc) noexcept
+        : alloc_(alloc)
+        , chunks_(ChunkAlloc(alloc)) {
+    }
+
+    explicit StableVector(size_t size, const Alloc& alloc = Alloc())
+        : StableVector(alloc)  // делегирование гарантирует разрушение элементов при исключении
+    {
+        Resize(size);
+    }
+
+    StableVector(std::initializer_list<T> init, const Alloc& alloc = Alloc())
+        : StableVector(alloc) {
+        Reserve(init.size());
+        for (const T& value : init) {
+            EmplaceBack(value);
+        }
+    }
+
+    StableVector(const StableVector& other)
+        : StableVector(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.alloc_)) {
+        Reserve(other.size_);
+        for (const T& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    StableVector(StableVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , chunks_(std::move(other.chunks_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    StableVector& operator=(const StableVector& rhs) {
+        if (this != &rhs) {
+            StableVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    // Блоки переходят вместе со своими аллокаторами, поэтому их можно передать при любом аллокаторе
+    StableVector& operator=(StableVector&& rhs) noexcept {
+        if (this != &rhs) {
+            StableVector rhs_moved(std::move(rhs));
+            Swap(rhs_moved);
+        }
+        return *this;
+    }
+
+    ~StableVector() {
+        Clear();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return chunks_.Size() * ChunkSize;
+    }
+
+    const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<StableVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return chunks_[index >> CHUNK_SHIFT][index & CHUNK_MASK];
+    }
+
+    // Выделяет блоки под new_capacity элементов, элементы при этом не переносятся
+    void Reserve(size_t new_capacity) {
+        const size_t chunk_count = (new_capacity + ChunkSize - 1) >> CHUNK_SHIFT;
+        chunks_.Reserve(chunk_count);
+        while (chunks_.Size() < chunk_count) {
+            chunks_.EmplaceBack(ChunkSize, alloc_);
+        }
+    }
+
+    // Новые элементы инициализируются значением. При исключении вектор не изменяется
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            while (size_ > new_size) {
+                PopBack();
             }
-            catch (...) {
-                std::destroy_n(begin(), count_prev);
+            return;
+        }
+        Reserve(new_size);
+        const size_t old_size = size_;
+        try {
+            // Элементы создаются по блокам, size_ растёт после каждого созданного участка
+            while (size_ < new_size) {
+                const size_t count = std::min(new_size - size_, ChunkSize - (size_ & CHUNK_MASK));
+                UninitializedValueConstructN(chunks_[size_ >> CHUNK_SHIFT] + (size_ & CHUNK_MASK), count);
+                size_ += count;
             }
-            try {
-                std::uninitialized_copy_n(begin() + count_prev, count_next, new_data.GetAddress() + count_prev + 1);
+        }
+        catch (...) {
+            while (size_ > old_size) {
+                PopBack();
             }
-            catch (...) {
-                std::destroy_n(begin() + count_prev, count_next);
+            throw;
+        }
+    }
+
+    // Аргументы могут ссылаться на элементы вектора: добавление блока их не перемещает
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            chunks_.EmplaceBack(ChunkSize, alloc_);
+        }
+        T* slot = chunks_[size_ >> CHUNK_SHIFT] + (size_ & CHUNK_MASK);
+        new (slot) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Блок не освобождается, чтобы чередование PushBack и PopBack на границе блока не выделяло память
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        std::destroy_at(chunks_[size_ >> CHUNK_SHIFT] + (size_ & CHUNK_MASK));
+    }
+
+    // Разрушает все элементы, сохраняя блоки
+    void Clear() noexcept {
+        for (size_t first = 0; first < size_; first += ChunkSize) {
+            std::destroy_n(chunks_[first >> CHUNK_SHIFT].GetAddress(), std::min(ChunkSize, size_ - first));
+        }
+        size_ = 0;
+    }
+
+    // Освобождает блоки, в которых нет элементов
+    void ShrinkToFit() {
+        const size_t chunk_count = (size_ + ChunkSize - 1) >> CHUNK_SHIFT;
+        while (chunks_.Size() > chunk_count) {
+            chunks_.PopBack();
+        }
+        chunks_.ShrinkToFit();
+    }
+
+    void Swap(StableVector& other) noexcept {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        chunks_.Swap(other.chunks_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    Alloc alloc_;
+    Vector<Chunk, ChunkAlloc> chunks_;
+    size_t size_ = 0;
+};
+
+// Непрерывный вектор с постепенной реаллокацией для задач, чувствительных к задержкам. При росте
+// старый и новый блоки RawMemory живут одновременно: новые элементы сразу создаются в новом блоке,
+// а старые переносятся в него небольшими порциями при последующих EmplaceBack, как при постепенном
+// рехешировании. Порция выбирается так, чтобы перенос закончился до заполнения нового блока.
+// operator[] во время переноса обращается к нужному блоку. Data, begin и end требуют непрерывности
+// и сначала завершают перенос, поэтому указатели, полученные от них, действительны до следующего роста.
+// Константные методы вектор не изменяют, и его можно читать из нескольких потоков одновременно;
+// константным Data, begin и end перенос должен быть завершён заранее вызовом FinishMigration.
+// Элементы должны перемещаться без исключений
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class IncrementalVector {
+    static_assert(IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>,
+                  "IncrementalVector requires nothrow relocatable elements");
+
+    using Memory = RawMemory<T, Alloc>;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    // Векторы меньше этого размера переносятся сразу: это дешевле, чем вести два блока
+    static constexpr size_t MIN_INCREMENTAL_SIZE = 1024;
+    // Наименьшее число элементов, переносимых одним EmplaceBack
+    static constexpr size_t MIN_STEP = 16;
+
+    IncrementalVector() = default;
+
+    explicit IncrementalVector(const Alloc& alloc) noexcept
+        : data_(alloc)
+        , old_(alloc) {
+    }
+
+    IncrementalVector(const IncrementalVector& other)
+        : IncrementalVector(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.GetAllocator())) {
+        Reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i) {
+            EmplaceBack(other[i]);
+        }
+    }
+
+    IncrementalVector(IncrementalVector&& other) noexcept
+        : data_(std::move(other.data_))
+        , old_(std::move(other.old_))
+        , size_(std::exchange(other.size_, 0))
+        , old_size_(std::exchange(other.old_size_, 0))
+        , migrated_(std::exchange(other.migrated_, 0))
+        , step_(std::exchange(other.step_, 0)) {
+    }
+
+    IncrementalVector& operator=(const IncrementalVector& rhs) {
+        if (this != &rhs) {
+            IncrementalVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    IncrementalVector& operator=(IncrementalVector&& rhs) noexcept {
+        if (this != &rhs) {
+            IncrementalVector rhs_moved(std::move(rhs));
+            Swap(rhs_moved);
+        }
+        return *this;
+    }
+
+    ~IncrementalVector() {
+        Clear();
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+    iterator end() noexcept {
+        return Data() + size_;
+    }
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    T* Data() noexcept {
+        FinishMigration();
+        return data_.GetAddress();
+    }
+
+    // Не завершает перенос, чтобы параллельное чтение константного вектора не было гонкой
+    const T* Data() const noexcept {
+        assert(!IsMigrating());
+        return data_.GetAddress();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    const Alloc& GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    // Возвращает true, пока часть элементов остаётся в старом блоке
+    bool IsMigrating() const noexcept {
+        return migrated_ < old_size_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return *Locate(index);
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Locate(index);
+    }
+
+    // Переносит оставшиеся элементы старого блока и освобождает его
+    void FinishMigration() noexcept {
+        if (IsMigrating()) {
+            MigrateStep(old_size_ - migrated_);
+        }
+    }
+
+    // Резервирование переносит элементы сразу: оно выполняется заранее, вне критичного по задержкам пути
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= data_.Capacity()) {
+            return;
+        }
+        FinishMigration();
+        Memory new_data(new_capacity, GetAllocator());
+        RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+        data_.Swap(new_data);
+    }
+
+    // Очередная порция переносится после создания элемента, так как args могут ссылаться
+    // на элементы старого блока
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == data_.Capacity()) {
+            Grow(std::forward<Args>(args)...);
+        }
+        else {
+            new (data_ + size_) T(std::forward<Args>(args)...);
+        }
+        ++size_;
+        if (IsMigrating()) {
+            MigrateStep(step_);
+        }
+        return data_[size_ - 1];
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        std::destroy_at(Locate(size_));
+        // Удалённый элемент больше не нужно переносить
+        if (old_size_ > size_) {
+            old_size_ = size_;
+            if (!IsMigrating()) {
+                ReleaseOld();
             }
+        }
+    }
 
+    // Разрушает все элементы, сохраняя ёмкость нового блока
+    void Clear() noexcept {
+        std::destroy_n(data_.GetAddress(), migrated_);
+        std::destroy(old_ + migrated_, old_ + old_size_);
+        std::destroy(data_ + old_size_, data_ + size_);
+        ReleaseOld();
+        size_ = 0;
+    }
+
+    void Swap(IncrementalVector& other) noexcept {
+        data_.Swap(other.data_);
+        old_.Swap(other.old_);
+        std::swap(size_, other.size_);
+        std::swap(old_size_, other.old_size_);
+        std::swap(migrated_, other.migrated_);
+        std::swap(step_, other.step_);
+    }
+
+private:
+    // Элементы [migrated_, old_size_) ещё в старом блоке, остальные - в новом
+    T* Locate(size_t index) noexcept {
+        return index >= migrated_ && index < old_size_ ? old_ + index : data_ + index;
+    }
+    const T* Locate(size_t index) const noexcept {
+        return index >= migrated_ && index < old_size_ ? old_ + index : data_ + index;
+    }
+
+    template <typename... Args>
+    void Grow(Args&&... args) {
+        const size_t new_capacity = Growth::template NextCapacity<T>(data_.Capacity(), size_ + 1);
+        if (!IsMigrating() && data_.TryExpand(new_capacity)) {
+            new (data_ + size_) T(std::forward<Args>(args)...);
+            return;
+        }
+        Memory new_data(new_capacity, GetAllocator());
+        // args могут ссылаться на элементы вектора, поэтому элемент создаётся до переноса
+        new (new_data + size_) T(std::forward<Args>(args)...);
+        // Перенос, не успевший закончиться к заполнению блока, завершается перед новым ростом
+        FinishMigration();
+        if (size_ < MIN_INCREMENTAL_SIZE) {
+            RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+            data_.Swap(new_data);
+            return;
         }
-        std::destroy_n(begin(), size_);
+        old_.Swap(data_);
         data_.Swap(new_data);
+        old_size_ = size_;
+        migrated_ = 0;
+        // Свободных мест new_capacity - size_, за это число добавлений нужно перенести size_ элементов
+        const size_t free_slots = new_capacity - size_ - 1;
+        step_ = std::max(MIN_STEP, free_slots == 0 ? size_ : (size_ + free_slots - 1) / free_slots);
     }
 
-    RawMemory<T> data_;
+    void MigrateStep(size_t count) noexcept {
+        const size_t n = std::min(count, old_size_ - migrated_);
+        RelocateN(old_ + migrated_, n, data_ + migrated_);
+        migrated_ += n;
+        if (!IsMigrating()) {
+            ReleaseOld();
+        }
+    }
+
+    void ReleaseOld() noexcept {
+        Memory empty(GetAllocator());
+        old_.Swap(empty);
+        old_size_ = 0;
+        migrated_ = 0;
+    }
+
+    Memory data_;
+    Memory old_;
     size_t size_ = 0;
-};
\ No newline at end of file
+    // Число элементов в момент роста и число уже перенесённых из них
+    size_t old_size_ = 0;
+    size_t migrated_ = 0;
+    size_t step_ = 0;
+};
@@ -0,0 +1,719 @@
+#pragma once
+#include "vector.h"
+
+#include <bitset>
+#include <cstdint>
+#include <optional>
+
+// Векторизованные Fill, Find, Count, MinElement и MaxElement для Vector и диапазонов указателей
+// над арифметическими типами. На x86-64 базовый путь использует SSE2, а AVX2 выбирается во время
+// выполнения по возможностям процессора (GCC и Clang). На AArch64 используется NEON.
+// Для остальных типов и платформ, а также с макросом VECTOR_NO_SIMD функции сводятся к std::
+#if !defined(VECTOR_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define VECTOR_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define VECTOR_SIMD_AVX2 1
+#include <immintrin.h>
+#if defined(__clang__)
+#define VECTOR_SIMD_AVX2_BEGIN \
+    _Pragma("clang attribute push(__attribute__((target(\"avx2,popcnt\"))), apply_to = function)")
+#define VECTOR_SIMD_AVX2_END _Pragma("clang attribute pop")
+#else
+#define VECTOR_SIMD_AVX2_BEGIN _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,popcnt\")")
+#define VECTOR_SIMD_AVX2_END _Pragma("GCC pop_options")
+#endif
+#endif
+#elif !defined(VECTOR_NO_SIMD) && defined(__aarch64__)
+#define VECTOR_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Типы, для которых есть векторные реализации
+template <typename T>
+inline constexpr bool IsSimdLaneV = (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+                                    || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Значение типа U, отличного от T (например, литерал int для Vector<uint8_t>), сравнивается
+// с элементами векторно, если его приведение к T определено: целые приводятся к любому T,
+// вещественные - только к не менее точному вещественному. Иначе работают функции std::
+template <typename T, typename U>
+inline constexpr bool IsSimdValueV = IsSimdLaneV<T> && std::is_arithmetic_v<U>
+                                     && (std::is_integral_v<U>
+                                         || (std::is_floating_point_v<T> && sizeof(U) <= sizeof(T)));
+
+// Возвращает true, если static_cast<T>(value) == value по правилам встроенного ==. Только тогда
+// элементы, равные value, - это в точности элементы, равные static_cast<T>(value), иначе
+// (300 для uint8_t, -1 для unsigned char, NaN) равных value элементов нет
+template <typename T, typename U>
+bool SimdSameValue(U value) noexcept {
+    using Common = std::common_type_t<T, U>;
+    return static_cast<Common>(static_cast<T>(value)) == static_cast<Common>(value);
+}
+
+inline size_t SimdCountTrailingZeros(uint64_t mask) noexcept {
+    assert(mask != 0);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctzll(mask));
+#endif
+}
+
+inline size_t SimdPopCount(uint64_t mask) noexcept {
+    return std::bitset<64>(mask).count();
+}
+
+// Каждый набор операций Ops<T> описывает регистр Reg из LANES элементов T и результат
+// сравнения Cmp, из которого Mask() получает маску по MASK_BITS_PER_BYTE бит на байт регистра.
+// Для float и double Unordered(a) отмечает элементы a, равные NaN
+
+#if defined(VECTOR_SIMD_SSE2)
+struct SimdSse2Base {
+    using Cmp = __m128i;
+    static constexpr size_t MASK_BITS_PER_BYTE = 1;
+
+    static Cmp Or(Cmp a, Cmp b) noexcept {
+        return _mm_or_si128(a, b);
+    }
+    static uint64_t Mask(Cmp cmp) noexcept {
+        return static_cast<uint32_t>(_mm_movemask_epi8(cmp));
+    }
+};
+
+template <typename T, typename = void>
+struct SimdSse2Ops {
+    static constexpr bool ENABLED = false;
+};
+
+template <typename T>
+struct SimdSse2Ops<T, std::enable_if_t<std::is_integral_v<T> && IsSimdLaneV<T>>> : SimdSse2Base {
+    using Reg = __m128i;
+    static constexpr bool ENABLED = true;
+    static constexpr bool HAS_MIN_MAX = sizeof(T) < 8;
+    static constexpr size_t LANES = sizeof(Reg) / sizeof(T);
+
+    static Reg Load(const T* p) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    static void Store(T* p, Reg r) noexcept {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), r);
+    }
+    static Reg Set1(T value) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return _mm_set1_epi8(static_cast<char>(value));
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return _mm_set1_epi16(static_cast<short>(value));
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return _mm_set1_epi32(static_cast<int>(value));
+        }
+        else {
+            return _mm_set1_epi64x(static_cast<long long>(value));
+        }
+    }
+    static Cmp Eq(Reg a, Reg b) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return _mm_cmpeq_epi8(a, b);
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return _mm_cmpeq_epi16(a, b);
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return _mm_cmpeq_epi32(a, b);
+        }
+        else {
+            // В SSE2 нет 64-битного сравнения: обе 32-битные половины должны совпасть
+            const __m128i eq = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+    static Reg Min(Reg a, Reg b) noexcept {
+        return Select(Less(a, b), a, b);
+    }
+    static Reg Max(Reg a, Reg b) noexcept {
+        return Select(Less(a, b), b, a);
+    }
+
+private:
+    // Маска элементов, для которых a < b. Беззнаковые (и знаковые байты) сравниваются
+    // знаковыми командами после сдвига диапазона инверсией старшего бита
+    static Reg Less(Reg a, Reg b) noexcept {
+        constexpr bool FLIP = std::is_unsigned_v<T> != (sizeof(T) == 1);
+        if constexpr (sizeof(T) == 1) {
+            if constexpr (FLIP) {
+                a = _mm_xor_si128(a, _mm_set1_epi8(static_cast<char>(0x80)));
+                b = _mm_xor_si128(b, _mm_set1_epi8(static_cast<char>(0x80)));
+            }
+            // Байты сравниваются как беззнаковые через минимум
+            return _mm_andnot_si128(_mm_cmpeq_epi8(_mm_min_epu8(b, a), b), _mm_set1_epi8(-1));
+        }
+        else if constexpr (sizeof(T) == 2) {
+            if constexpr (FLIP) {
+                a = _mm_xor_si128(a, _mm_set1_epi16(static_cast<short>(0x8000)));
+                b = _mm_xor_si128(b, _mm_set1_epi16(static_cast<short>(0x8000)));
+            }
+            return _mm_cmplt_epi16(a, b);
+        }
+        else {
+            if constexpr (FLIP) {
+                a = _mm_xor_si128(a, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+                b = _mm_xor_si128(b, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+            }
+            return _mm_cmplt_epi32(a, b);
+        }
+    }
+    static Reg Select(Reg mask, Reg a, Reg b) noexcept {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+};
+
+template <>
+struct SimdSse2Ops<float> : SimdSse2Base {
+    using Reg = __m128;
+    static constexpr bool ENABLED = true;
+    static constexpr bool HAS_MIN_MAX = true;
+    static constexpr size_t LANES = 4;
+
+    static Reg Load(const float* p) noexcept {
+        return _mm_loadu_ps(p);
+    }
+    static void Store(float* p, Reg r) noexcept {
+        _mm_storeu_ps(p, r);
+    }
+    static Reg Set1(float value) noexcept {
+        return _mm_set1_ps(value);
+    }
+    static Cmp Eq(Reg a, Reg b) noexcept {
+        return _mm_castps_si128(_mm_cmpeq_ps(a, b));
+    }
+    static Reg Min(Reg a, Reg b) noexcept {
+        return _mm_min_ps(a, b);
+    }
+    static Reg Max(Reg a, Reg b) noexcept {
+        return _mm_max_ps(a, b);
+    }
+    static Cmp Unordered(Reg a) noexcept {
+        return _mm_castps_si128(_mm_cmpunord_ps(a, a));
+    }
+};
+
+template <>
+struct SimdSse2Ops<double> : SimdSse2Base {
+    using Reg = __m128d;
+    static constexpr bool ENABLED = true;
+    static constexpr bool HAS_MIN_MAX = true;
+    static constexpr size_t LANES = 2;
+
+    static Reg Load(const double* p) noexcept {
+        return _mm_loadu_pd(p);
+    }
+    static void Store(double* p, Reg r) noexcept {
+        _mm_storeu_pd(p, r);
+    }
+    static Reg Set1(double value) noexcept {
+        return _mm_set1_pd(value);
+    }
+    static Cmp Eq(Reg a, Reg b) noexcept {
+        return _mm_castpd_si128(_mm_cmpeq_pd(a, b));
+    }
+    static Reg Min(Reg a, Reg b) noexcept {
+        return _mm_min_pd(a, b);
+    }
+    static Reg Max(Reg a, Reg b) noexcept {
+        return _mm_max_pd(a, b);
+    }
+    static Cmp Unordered(Reg a) noexcept {
+        return _mm_castpd_si128(_mm_cmpunord_pd(a, a));
+    }
+};
+
+template <typename T>
+using SimdBaseOps = SimdSse2Ops<T>;
+#endif
+
+#if defined(VECTOR_SIMD_NEON)
+struct SimdNeonBase {
+    using Cmp = uint8x16_t;
+    // В NEON нет movemask: сужающий сдвиг оставляет по 4 бита на каждый байт сравнения
+    static constexpr size_t MASK_BITS_PER_BYTE = 4;
+
+    static Cmp Or(Cmp a, Cmp b) noexcept {
+        return vorrq_u8(a, b);
+    }
+    static uint64_t Mask(Cmp cmp) noexcept {
+        return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+    }
+};
+
+template <typename T, typename = void>
+struct SimdNeonOps {
+    static constexpr bool ENABLED = false;
+};
+
+// Целые любой ширины хранятся в uint8x16_t и приводятся к нужному типу в каждой операции
+template <typename T>
+struct SimdNeonOps<T, std::enable_if_t<std::is_integral_v<T> && IsSimdLaneV<T>>> : SimdNeonBase {
+    using Reg = uint8x16_t;
+    static constexpr bool ENABLED = true;
+    static constexpr bool HAS_MIN_MAX = sizeof(T) < 8;
+    static constexpr size_t LANES = sizeof(Reg) / sizeof(T);
+
+    static Reg Load(const T* p) noexcept {
+        return vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    }
+    static void Store(T* p, Reg r) noexcept {
+        vst1q_u8(reinterpret_cast<uint8_t*>(p), r);
+    }
+    static Reg Set1(T value) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return vdupq_n_u8(static_cast<uint8_t>(value));
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return vreinterpretq_u8_u16(vdupq_n_u16(static_cast<uint16_t>(value)));
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return vreinterpretq_u8_u32(vdupq_n_u32(static_cast<uint32_t>(value)));
+        }
+        else {
+            return vreinterpretq_u8_u64(vdupq_n_u64(static_cast<uint64_t>(value)));
+        }
+    }
+    static Cmp Eq(Reg a, Reg b) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return vceqq_u8(a, b);
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+        }
+        else {
+            return vreinterpretq_u8_u64(vceqq_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+        }
+    }
+    static Reg Min(Reg a, Reg b) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return std::is_signed_v<T>
+                ? vreinterpretq_u8_s8(vminq_s8(vreinterpretq_s8_u8(a), vreinterpretq_s8_u8(b)))
+                : vminq_u8(a, b);
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return std::is_signed_v<T>
+                ? vreinterpretq_u8_s16(vminq_s16(vreinterpretq_s16_u8(a), vreinterpretq_s16_u8(b)))
+                : vreinterpretq_u8_u16(vminq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+        }
+        else {
+            return std::is_signed_v<T>
+                ? vreinterpretq_u8_s32(vminq_s32(vreinterpretq_s32_u8(a), vreinterpretq_s32_u8(b)))
+                : vreinterpretq_u8_u32(vminq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+        }
+    }
+    static Reg Max(Reg a, Reg b) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return std::is_signed_v<T>
+                ? vreinterpretq_u8_s8(vmaxq_s8(vreinterpretq_s8_u8(a), vreinterpretq_s8_u8(b)))
+                : vmaxq_u8(a, b);
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return std::is_signed_v<T>
+                ? vreinterpretq_u8_s16(vmaxq_s16(vreinterpretq_s16_u8(a), vreinterpretq_s16_u8(b)))
+                : vreinterpretq_u8_u16(vmaxq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+        }
+        else {
+            return std::is_signed_v<T>
+                ? vreinterpretq_u8_s32(vmaxq_s32(vreinterpretq_s32_u8(a), vreinterpretq_s32_u8(b)))
+                : vreinterpretq_u8_u32(vmaxq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+        }
+    }
+};
+
+template <>
+struct SimdNeonOps<float> : SimdNeonBase {
+    using Reg = float32x4_t;
+    static constexpr bool ENABLED = true;
+    static constexpr bool HAS_MIN_MAX = true;
+    static constexpr size_t LANES = 4;
+
+    static Reg Load(const float* p) noexcept {
+        return vld1q_f32(p);
+    }
+    static void Store(float* p, Reg r) noexcept {
+        vst1q_f32(p, r);
+    }
+    static Reg Set1(float value) noexcept {
+        return vdupq_n_f32(value);
+    }
+    static Cmp Eq(Reg a, Reg b) noexcept {
+        return vreinterpretq_u8_u32(vceqq_f32(a, b));
+    }
+    static Reg Min(Reg a, Reg b) noexcept {
+        return vminq_f32(a, b);
+    }
+    static Reg Max(Reg a, Reg b) noexcept {
+        return vmaxq_f32(a, b);
+    }
+    static Cmp Unordered(Reg a) noexcept {
+        return vmvnq_u8(vreinterpretq_u8_u32(vceqq_f32(a, a)));
+    }
+};
+
+template <>
+struct SimdNeonOps<double> : SimdNeonBase {
+    using Reg = float64x2_t;
+    static constexpr bool ENABLED = true;
+    static constexpr bool HAS_MIN_MAX = true;
+    static constexpr size_t LANES = 2;
+
+    static Reg Load(const double* p) noexcept {
+        return vld1q_f64(p);
+    }
+    static void Store(double* p, Reg r) noexcept {
+        vst1q_f64(p, r);
+    }
+    static Reg Set1(double value) noexcept {
+        return vdupq_n_f64(value);
+    }
+    static Cmp Eq(Reg a, Reg b) noexcept {
+        return vreinterpretq_u8_u64(vceqq_f64(a, b));
+    }
+    static Reg Min(Reg a, Reg b) noexcept {
+        return vminq_f64(a, b);
+    }
+    static Reg Max(Reg a, Reg b) noexcept {
+        return vmaxq_f64(a, b);
+    }
+    static Cmp Unordered(Reg a) noexcept {
+        return vmvnq_u8(vreinterpretq_u8_u64(vceqq_f64(a, a)));
+    }
+};
+
+template <typename T>
+using SimdBaseOps = SimdNeonOps<T>;
+#endif
+
+#if defined(VECTOR_SIMD_SSE2) || defined(VECTOR_SIMD_NEON)
+#define VECTOR_SIMD_BASE 1
+
+namespace vector_simd_base {
+
+template <typename T>
+using Ops = SimdBaseOps<T>;
+
+#include "vector_algorithms_impl.h"
+
+}  // namespace vector_simd_base
+#endif
+
+#if defined(VECTOR_SIMD_AVX2)
+inline bool SimdHasAvx2() noexcept {
+#if defined(__AVX2__)
+    return true;
+#else
+    static const bool has_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    return has_avx2;
+#endif
+}
+
+// Всё, что определено до VECTOR_SIMD_AVX2_END, компилируется с AVX2 и вызывается только после SimdHasAvx2()
+VECTOR_SIMD_AVX2_BEGIN
+
+struct SimdAvx2Base {
+    using Cmp = __m256i;
+    static constexpr size_t MASK_BITS_PER_BYTE = 1;
+
+    static Cmp Or(Cmp a, Cmp b) noexcept {
+        return _mm256_or_si256(a, b);
+    }
+    static uint64_t Mask(Cmp cmp) noexcept {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(cmp));
+    }
+};
+
+template <typename T, typename = void>
+struct SimdAvx2Ops {
+    static constexpr bool ENABLED = false;
+};
+
+template <typename T>
+struct SimdAvx2Ops<T, std::enable_if_t<std::is_integral_v<T> && IsSimdLaneV<T>>> : SimdAvx2Base {
+    using Reg = __m256i;
+    static constexpr bool ENABLED = true;
+    static constexpr bool HAS_MIN_MAX = sizeof(T) < 8;
+    static constexpr size_t LANES = sizeof(Reg) / sizeof(T);
+
+    static Reg Load(const T* p) noexcept {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static void Store(T* p, Reg r) noexcept {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r);
+    }
+    static Reg Set1(T value) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return _mm256_set1_epi8(static_cast<char>(value));
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return _mm256_set1_epi16(static_cast<short>(value));
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return _mm256_set1_epi32(static_cast<int>(value));
+        }
+        else {
+            return _mm256_set1_epi64x(static_cast<long long>(value));
+        }
+    }
+    static Cmp Eq(Reg a, Reg b) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return _mm256_cmpeq_epi8(a, b);
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return _mm256_cmpeq_epi16(a, b);
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return _mm256_cmpeq_epi32(a, b);
+        }
+        else {
+            return _mm256_cmpeq_epi64(a, b);
+        }
+    }
+    static Reg Min(Reg a, Reg b) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return std::is_signed_v<T> ? _mm256_min_epi8(a, b) : _mm256_min_epu8(a, b);
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return std::is_signed_v<T> ? _mm256_min_epi16(a, b) : _mm256_min_epu16(a, b);
+        }
+        else {
+            return std::is_signed_v<T> ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b);
+        }
+    }
+    static Reg Max(Reg a, Reg b) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return std::is_signed_v<T> ? _mm256_max_epi8(a, b) : _mm256_max_epu8(a, b);
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return std::is_signed_v<T> ? _mm256_max_epi16(a, b) : _mm256_max_epu16(a, b);
+        }
+        else {
+            return std::is_signed_v<T> ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b);
+        }
+    }
+};
+
+template <>
+struct SimdAvx2Ops<float> : SimdAvx2Base {
+    using Reg = __m256;
+    static constexpr bool ENABLED = true;
+    static constexpr bool HAS_MIN_MAX = true;
+    static constexpr size_t LANES = 8;
+
+    static Reg Load(const float* p) noexcept {
+        return _mm256_loadu_ps(p);
+    }
+    static void Store(float* p, Reg r) noexcept {
+        _mm256_storeu_ps(p, r);
+    }
+    static Reg Set1(float value) noexcept {
+        return _mm256_set1_ps(value);
+    }
+    static Cmp Eq(Reg a, Reg b) noexcept {
+        return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+    }
+    static Reg Min(Reg a, Reg b) noexcept {
+        return _mm256_min_ps(a, b);
+    }
+    static Reg Max(Reg a, Reg b) noexcept {
+        return _mm256_max_ps(a, b);
+    }
+    static Cmp Unordered(Reg a) noexcept {
+        return _mm256_castps_si256(_mm256_cmp_ps(a, a, _CMP_UNORD_Q));
+    }
+};
+
+template <>
+struct SimdAvx2Ops<double> : SimdAvx2Base {
+    using Reg = __m256d;
+    static constexpr bool ENABLED = true;
+    static constexpr bool HAS_MIN_MAX = true;
+    static constexpr size_t LANES = 4;
+
+    static Reg Load(const double* p) noexcept {
+        return _mm256_loadu_pd(p);
+    }
+    static void Store(double* p, Reg r) noexcept {
+        _mm256_storeu_pd(p, r);
+    }
+    static Reg Set1(double value) noexcept {
+        return _mm256_set1_pd(value);
+    }
+    static Cmp Eq(Reg a, Reg b) noexcept {
+        return _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+    }
+    static Reg Min(Reg a, Reg b) noexcept {
+        return _mm256_min_pd(a, b);
+    }
+    static Reg Max(Reg a, Reg b) noexcept {
+        return _mm256_max_pd(a, b);
+    }
+    static Cmp Unordered(Reg a) noexcept {
+        return _mm256_castpd_si256(_mm256_cmp_pd(a, a, _CMP_UNORD_Q));
+    }
+};
+
+namespace vector_simd_avx2 {
+
+template <typename T>
+using Ops = SimdAvx2Ops<T>;
+
+#include "vector_algorithms_impl.h"
+
+}  // namespace vector_simd_avx2
+
+VECTOR_SIMD_AVX2_END
+#endif
+
+template <typename T, typename U>
+void Fill(T* first, T* last, const U& value) {
+    if constexpr (IsSimdValueV<T, U>) {
+#if defined(VECTOR_SIMD_AVX2)
+        if (SimdHasAvx2()) {
+            return vector_simd_avx2::Fill(first, last, static_cast<T>(value));
+        }
+#endif
+#if defined(VECTOR_SIMD_BASE)
+        return vector_simd_base::Fill(first, last, static_cast<T>(value));
+#endif
+    }
+    std::fill(first, last, value);
+}
+
+template <typename T, typename U>
+const T* Find(const T* first, const T* last, const U& value) {
+    if constexpr (IsSimdValueV<T, U>) {
+        if (!SimdSameValue<T>(value)) {
+            return last;
+        }
+#if defined(VECTOR_SIMD_AVX2)
+        if (SimdHasAvx2()) {
+            return vector_simd_avx2::Find(first, last, static_cast<T>(value));
+        }
+#endif
+#if defined(VECTOR_SIMD_BASE)
+        return vector_simd_base::Find(first, last, static_cast<T>(value));
+#endif
+    }
+    return std::find(first, last, value);
+}
+
+template <typename T, typename U>
+size_t Count(const T* first, const T* last, const U& value) {
+    if constexpr (IsSimdValueV<T, U>) {
+        if (!SimdSameValue<T>(value)) {
+            return 0;
+        }
+#if defined(VECTOR_SIMD_AVX2)
+        if (SimdHasAvx2()) {
+            return vector_simd_avx2::Count(first, last, static_cast<T>(value));
+        }
+#endif
+#if defined(VECTOR_SIMD_BASE)
+        return vector_simd_base::Count(first, last, static_cast<T>(value));
+#endif
+    }
+    return static_cast<size_t>(std::count(first, last, value));
+}
+
+// Векторно находит минимум (IS_MIN) или максимум, затем его первое вхождение через Find.
+// Векторные min и max теряют NaN, поэтому при NaN в данных результат даёт последовательный поиск
+template <bool IS_MIN, typename T>
+const T* MinMaxElement(const T* first, const T* last) {
+    // Короткие диапазоны быстрее обработать последовательно
+    constexpr size_t MIN_SIMD_SIZE = 64;
+    if constexpr (IsSimdLaneV<T>) {
+        if (static_cast<size_t>(last - first) >= MIN_SIMD_SIZE) {
+            std::optional<T> value;
+            [[maybe_unused]] bool reduced = false;
+#if defined(VECTOR_SIMD_AVX2)
+            if constexpr (SimdAvx2Ops<T>::HAS_MIN_MAX) {
+                if (SimdHasAvx2()) {
+                    value = vector_simd_avx2::MinMax<IS_MIN>(first, last);
+                    reduced = true;
+                }
+            }
+#endif
+#if defined(VECTOR_SIMD_BASE)
+            if constexpr (SimdBaseOps<T>::HAS_MIN_MAX) {
+                if (!reduced) {
+                    value = vector_simd_base::MinMax<IS_MIN>(first, last);
+                }
+            }
+#endif
+            if (value) {
+                if (const T* pos = Find(first, last, *value); pos != last) {
+                    return pos;
+                }
+            }
+        }
+    }
+    return IS_MIN ? std::min_element(first, last) : std::max_element(first, last);
+}
+
+template <typename T>
+const T* MinElement(const T* first, const T* last) {
+    return MinMaxElement<true>(first, last);
+}
+
+template <typename T>
+const T* MaxElement(const T* first, const T* last) {
+    return MinMaxElement<false>(first, last);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation, typename U>
+void Fill(Vector<T, Alloc, Growth, Stats, Relocation>& vector, const U& value) {
+    Fill(vector.begin(), vector.end(), value);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation, typename U>
+typename Vector<T, Alloc, Growth, Stats, Relocation>::const_iterator Find(const Vector<T, Alloc, Growth, Stats, Relocation>& vector,
+                                                              const U& value) {
+    return Find(vector.cbegin(), vector.cend(), value);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation, typename U>
+typename Vector<T, Alloc, Growth, Stats, Relocation>::iterator Find(Vector<T, Alloc, Growth, Stats, Relocation>& vector,
+                                                        const U& value) {
+    return vector.begin() + (Find(vector.cbegin(), vector.cend(), value) - vector.cbegin());
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation, typename U>
+size_t Count(const Vector<T, Alloc, Growth, Stats, Relocation>& vector, const U& value) {
+    return Count(vector.cbegin(), vector.cend(), value);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+typename Vector<T, Alloc, Growth, Stats, Relocation>::const_iterator MinElement(const Vector<T, Alloc, Growth, Stats, Relocation>& vector) {
+    return MinElement(vector.cbegin(), vector.cend());
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+typename Vector<T, Alloc, Growth, Stats, Relocation>::iterator MinElement(Vector<T, Alloc, Growth, Stats, Relocation>& vector) {
+    return vector.begin() + (MinElement(vector.cbegin(), vector.cend()) - vector.cbegin());
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+typename Vector<T, Alloc, Growth, Stats, Relocation>::const_iterator MaxElement(const Vector<T, Alloc, Growth, Stats, Relocation>& vector) {
+    return MaxElement(vector.cbegin(), vector.cend());
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+typename Vector<T, Alloc, Growth, Stats, Relocation>::iterator MaxElement(Vector<T, Alloc, Growth, Stats, Relocation>& vector) {
+    return vector.begin() + (MaxElement(vector.cbegin(), vector.cend()) - vector.cbegin());
+}
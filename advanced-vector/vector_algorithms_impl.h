@@ -0,0 +1,92 @@
+// Обобщённые векторные реализации над набором операций Ops<T> (см. vector_algorithms.h).
+// Файл намеренно без #pragma once: он включается внутрь пространства имён для каждого набора
+// команд, чтобы код компилировался с соответствующими опциями target
+
+template <typename T>
+void Fill(T* first, T* last, T value) noexcept {
+    const auto reg = Ops<T>::Set1(value);
+    for (; static_cast<size_t>(last - first) >= Ops<T>::LANES; first += Ops<T>::LANES) {
+        Ops<T>::Store(first, reg);
+    }
+    std::fill(first, last, value);
+}
+
+template <typename T>
+const T* Find(const T* first, const T* last, T value) noexcept {
+    constexpr size_t LANES = Ops<T>::LANES;
+    constexpr size_t MASK_BITS = Ops<T>::MASK_BITS_PER_BYTE * sizeof(T);
+    const auto needle = Ops<T>::Set1(value);
+    // Четыре регистра за итерацию, точное место совпадения ищется только когда оно есть
+    for (; static_cast<size_t>(last - first) >= 4 * LANES; first += 4 * LANES) {
+        const typename Ops<T>::Cmp eqs[] = {
+            Ops<T>::Eq(Ops<T>::Load(first), needle),
+            Ops<T>::Eq(Ops<T>::Load(first + LANES), needle),
+            Ops<T>::Eq(Ops<T>::Load(first + 2 * LANES), needle),
+            Ops<T>::Eq(Ops<T>::Load(first + 3 * LANES), needle),
+        };
+        if (Ops<T>::Mask(Ops<T>::Or(Ops<T>::Or(eqs[0], eqs[1]), Ops<T>::Or(eqs[2], eqs[3]))) != 0) {
+            for (size_t i = 0;; ++i) {
+                if (const uint64_t mask = Ops<T>::Mask(eqs[i]); mask != 0) {
+                    return first + i * LANES + SimdCountTrailingZeros(mask) / MASK_BITS;
+                }
+            }
+        }
+    }
+    for (; static_cast<size_t>(last - first) >= LANES; first += LANES) {
+        if (const uint64_t mask = Ops<T>::Mask(Ops<T>::Eq(Ops<T>::Load(first), needle)); mask != 0) {
+            return first + SimdCountTrailingZeros(mask) / MASK_BITS;
+        }
+    }
+    return std::find(first, last, value);
+}
+
+template <typename T>
+size_t Count(const T* first, const T* last, T value) noexcept {
+    const auto needle = Ops<T>::Set1(value);
+    size_t mask_bits = 0;
+    for (; static_cast<size_t>(last - first) >= Ops<T>::LANES; first += Ops<T>::LANES) {
+        mask_bits += SimdPopCount(Ops<T>::Mask(Ops<T>::Eq(Ops<T>::Load(first), needle)));
+    }
+    return mask_bits / (Ops<T>::MASK_BITS_PER_BYTE * sizeof(T)) + std::count(first, last, value);
+}
+
+// Минимум (IS_MIN) или максимум значений диапазона не короче Ops<T>::LANES.
+// Если в диапазоне есть NaN, возвращает std::nullopt
+template <bool IS_MIN, typename T>
+std::optional<T> MinMax(const T* first, const T* last) noexcept {
+    constexpr size_t LANES = Ops<T>::LANES;
+    constexpr bool HAS_NAN = std::is_floating_point_v<T>;
+    assert(static_cast<size_t>(last - first) >= LANES);
+    auto acc = Ops<T>::Load(first);
+    [[maybe_unused]] typename Ops<T>::Cmp unordered{};
+    if constexpr (HAS_NAN) {
+        unordered = Ops<T>::Unordered(acc);
+    }
+    for (first += LANES; static_cast<size_t>(last - first) >= LANES; first += LANES) {
+        const auto reg = Ops<T>::Load(first);
+        if constexpr (HAS_NAN) {
+            unordered = Ops<T>::Or(unordered, Ops<T>::Unordered(reg));
+        }
+        acc = IS_MIN ? Ops<T>::Min(acc, reg) : Ops<T>::Max(acc, reg);
+    }
+    if constexpr (HAS_NAN) {
+        if (Ops<T>::Mask(unordered) != 0) {
+            return std::nullopt;
+        }
+    }
+    T lanes[LANES];
+    Ops<T>::Store(lanes, acc);
+    T result = lanes[0];
+    for (const T* it = lanes + 1; it != lanes + LANES; ++it) {
+        result = IS_MIN ? std::min(result, *it) : std::max(result, *it);
+    }
+    for (; first != last; ++first) {
+        if constexpr (HAS_NAN) {
+            if (*first != *first) {
+                return std::nullopt;
+            }
+        }
+        result = IS_MIN ? std::min(result, *first) : std::max(result, *first);
+    }
+    return result;
+}
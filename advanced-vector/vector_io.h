@@ -0,0 +1,221 @@
+#pragma once
+#include "vector.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define VECTOR_HAS_FD_IO 1
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+// Двоичная сериализация Vector. Формат: заголовок VectorStreamHeader и элементы в порядке
+// следования. Тривиально копируемые элементы пишутся и читаются одним блоком в собственном
+// порядке байт платформы, остальные - поэлементно через кодек VectorCodec<T>
+
+struct VectorStreamHeader {
+    static constexpr char MAGIC[4] = { 'A', 'V', 'S', '1' };
+
+    char magic[4];
+    // sizeof(T) для блочного формата и 0 для поэлементного
+    uint32_t element_size;
+    uint64_t size;
+};
+
+// Кодек для поэлементной сериализации нетривиальных типов. Специализация должна содержать
+//     static void Write(std::ostream& out, const T& value);
+//     static T Read(std::istream& in);
+// Read при ошибке формата бросает исключение
+template <typename T, typename = void>
+struct VectorCodec;
+
+template <typename Char, typename Traits, typename StrAlloc>
+struct VectorCodec<std::basic_string<Char, Traits, StrAlloc>> {
+    using String = std::basic_string<Char, Traits, StrAlloc>;
+
+    static void Write(std::ostream& out, const String& value) {
+        const uint64_t length = value.size();
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(reinterpret_cast<const char*>(value.data()), static_cast<std::streamsize>(length * sizeof(Char)));
+    }
+
+    static String Read(std::istream& in) {
+        uint64_t length = 0;
+        if (!in.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+            throw std::runtime_error("Unexpected end of vector stream");
+        }
+        String value;
+        // Длина из потока не проверена, поэтому строка растёт по мере чтения
+        const uint64_t CHUNK = 1 << 16;
+        for (uint64_t read = 0; read < length;) {
+            const size_t count = static_cast<size_t>(std::min(CHUNK, length - read));
+            value.resize(value.size() + count);
+            if (!in.read(reinterpret_cast<char*>(value.data() + read), static_cast<std::streamsize>(count * sizeof(Char)))) {
+                throw std::runtime_error("Unexpected end of vector stream");
+            }
+            read += count;
+        }
+        return value;
+    }
+};
+
+// Элементы читаются порциями не больше этого размера, чтобы повреждённый заголовок
+// с огромным размером не приводил к выделению памяти сверх реально прочитанных данных
+inline constexpr size_t VECTOR_IO_CHUNK_BYTES = size_t{ 1 } << 24;
+
+template <typename T>
+VectorStreamHeader MakeVectorStreamHeader(size_t size) noexcept {
+    VectorStreamHeader header{};
+    std::copy_n(VectorStreamHeader::MAGIC, sizeof(header.magic), header.magic);
+    header.element_size = std::is_trivially_copyable_v<T> ? static_cast<uint32_t>(sizeof(T)) : 0;
+    header.size = size;
+    return header;
+}
+
+template <typename T>
+void CheckVectorStreamHeader(const VectorStreamHeader& header) {
+    if (!std::equal(header.magic, header.magic + sizeof(header.magic), VectorStreamHeader::MAGIC)) {
+        throw std::runtime_error("Not a vector stream");
+    }
+    if (header.element_size != MakeVectorStreamHeader<T>(0).element_size) {
+        throw std::runtime_error("Vector stream stores elements of a different type");
+    }
+}
+
+// Читает в конец vector count тривиально копируемых элементов. read(dst, bytes) читает
+// до bytes байт и возвращает число прочитанных, 0 - конец данных. Память растёт порциями
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation, typename ReadFn>
+void ReadTriviallyCopyable(Vector<T, Alloc, Growth, Stats, Relocation>& vector, size_t count, ReadFn read) {
+    const size_t CHUNK = std::max<size_t>(1, VECTOR_IO_CHUNK_BYTES / sizeof(T));
+    size_t remaining = count;
+    while (remaining != 0) {
+        const size_t chunk = std::min(remaining, CHUNK);
+        const size_t old_size = vector.Size();
+        if (old_size + chunk > vector.Capacity()) {
+            vector.Reserve(std::min(old_size + remaining, std::max(old_size + chunk, vector.Capacity() * 2)));
+        }
+        // ResizeAndOverwrite не заполняет новую память перед чтением
+        vector.ResizeAndOverwrite(old_size + chunk, [&](T* data, size_t /*size*/) {
+            char* dst = reinterpret_cast<char*>(data + old_size);
+            const size_t bytes = chunk * sizeof(T);
+            for (size_t done = 0; done < bytes;) {
+                const size_t got = read(dst + done, bytes - done);
+                if (got == 0) {
+                    throw std::runtime_error("Unexpected end of vector stream");
+                }
+                done += got;
+            }
+            return old_size + chunk;
+        });
+        remaining -= chunk;
+    }
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+void WriteTo(const Vector<T, Alloc, Growth, Stats, Relocation>& vector, std::ostream& out) {
+    const VectorStreamHeader header = MakeVectorStreamHeader<T>(vector.Size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        out.write(reinterpret_cast<const char*>(vector.begin()),
+                  static_cast<std::streamsize>(vector.Size() * sizeof(T)));
+    }
+    else {
+        for (const T& value : vector) {
+            VectorCodec<T>::Write(out, value);
+        }
+    }
+    if (!out) {
+        throw std::runtime_error("Cannot write vector stream");
+    }
+}
+
+// Заменяет содержимое vector прочитанным из in. При исключении vector не изменяется
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+void ReadFrom(Vector<T, Alloc, Growth, Stats, Relocation>& vector, std::istream& in) {
+    VectorStreamHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Unexpected end of vector stream");
+    }
+    CheckVectorStreamHeader<T>(header);
+    Vector<T, Alloc, Growth, Stats, Relocation> result(vector.GetAllocator());
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        ReadTriviallyCopyable(result, static_cast<size_t>(header.size), [&in](char* dst, size_t bytes) {
+            in.read(dst, static_cast<std::streamsize>(bytes));
+            return static_cast<size_t>(in.gcount());
+        });
+    }
+    else {
+        for (uint64_t i = 0; i < header.size; ++i) {
+            result.PushBack(VectorCodec<T>::Read(in));
+        }
+    }
+    vector.Swap(result);
+}
+
+#if defined(VECTOR_HAS_FD_IO)
+// Записывает vector в файловый дескриптор. Заголовок и элементы уходят одним writev,
+// частичная запись продолжается с места остановки
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+void WriteTo(const Vector<T, Alloc, Growth, Stats, Relocation>& vector, int fd) {
+    static_assert(std::is_trivially_copyable_v<T>, "Writing to a descriptor requires trivially copyable T");
+    const VectorStreamHeader header = MakeVectorStreamHeader<T>(vector.Size());
+    iovec parts[] = {
+        { const_cast<VectorStreamHeader*>(&header), sizeof(header) },
+        { const_cast<T*>(vector.begin()), vector.Size() * sizeof(T) },
+    };
+    const size_t PARTS = std::size(parts);
+    // Система может записать меньше запрошенного (Linux - не больше ~2 ГБ за вызов)
+    for (size_t part = 0; part < PARTS;) {
+        const ssize_t written = ::writev(fd, parts + part, static_cast<int>(PARTS - part));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "Cannot write vector");
+        }
+        size_t left = static_cast<size_t>(written);
+        for (; part < PARTS && left >= parts[part].iov_len; ++part) {
+            left -= parts[part].iov_len;
+        }
+        if (part < PARTS) {
+            parts[part].iov_base = static_cast<char*>(parts[part].iov_base) + left;
+            parts[part].iov_len -= left;
+        }
+    }
+}
+
+// Заменяет содержимое vector прочитанным из файлового дескриптора. При исключении vector не изменяется
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation>
+void ReadFrom(Vector<T, Alloc, Growth, Stats, Relocation>& vector, int fd) {
+    static_assert(std::is_trivially_copyable_v<T>, "Reading from a descriptor requires trivially copyable T");
+    const auto read = [fd](char* dst, size_t bytes) {
+        for (;;) {
+            const ssize_t got = ::read(fd, dst, std::min(bytes, size_t{ 1 } << 30));
+            if (got >= 0) {
+                return static_cast<size_t>(got);
+            }
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "Cannot read vector");
+            }
+        }
+    };
+    VectorStreamHeader header{};
+    for (size_t done = 0; done < sizeof(header);) {
+        const size_t got = read(reinterpret_cast<char*>(&header) + done, sizeof(header) - done);
+        if (got == 0) {
+            throw std::runtime_error("Unexpected end of vector stream");
+        }
+        done += got;
+    }
+    CheckVectorStreamHeader<T>(header);
+    Vector<T, Alloc, Growth, Stats, Relocation> result(vector.GetAllocator());
+    ReadTriviallyCopyable(result, static_cast<size_t>(header.size), read);
+    vector.Swap(result);
+}
+#endif
@@ -0,0 +1,361 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+// Пул потоков для параллельной обработки диапазонов индексов. Диапазон делится на части,
+// каждый участник получает непрерывную группу частей и обрабатывает её с начала, а закончив,
+// забирает необработанные части у других участников. Благодаря этому при равномерной нагрузке
+// одна и та же часть данных попадает в один и тот же поток (что важно для first touch на NUMA),
+// а при неравномерной работа перераспределяется. Вызывающий поток участвует в работе.
+// Одновременно выполняется одна задача, вложенный вызов из задачи выполняется последовательно
+class ThreadPool {
+public:
+    // Каждый участник получает столько частей, чтобы было что перераспределять
+    static constexpr size_t CHUNKS_PER_THREAD = 8;
+
+    // threads - число участников вместе с вызывающим потоком
+    explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        : ranges_(new Range[std::max<size_t>(threads, 1)]) {
+        workers_.Reserve(threads > 1 ? threads - 1 : 0);
+        try {
+            for (size_t i = 1; i < threads; ++i) {
+                workers_.EmplaceBack([this, i] {
+                    WorkerLoop(i);
+                });
+            }
+        }
+        catch (...) {
+            // Уже запущенные потоки нужно остановить и дождаться, иначе их разрушение вызовет terminate
+            Stop();
+            throw;
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        Stop();
+    }
+
+    // Пул, используемый по умолчанию, с потоком на каждое ядро
+    static ThreadPool& Default() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    size_t Size() const noexcept {
+        return workers_.Size() + 1;
+    }
+
+    // Вызывает body(begin, end) для частей [0, count) размером не меньше grain. Первое исключение
+    // из body прекращает выдачу новых частей и передаётся вызывающему после завершения начатых
+    template <typename Body>
+    void ParallelFor(size_t count, size_t grain, Body body) {
+        const size_t chunks = std::min((count + std::max<size_t>(grain, 1) - 1) / std::max<size_t>(grain, 1),
+                                       Size() * CHUNKS_PER_THREAD);
+        if (chunks <= 1 || Size() == 1 || current_ == this) {
+            if (count != 0) {
+                body(size_t{ 0 }, count);
+            }
+            return;
+        }
+        Job job;
+        job.count = count;
+        job.chunks = chunks;
+        job.context = &body;
+        job.run = [](void* context, size_t begin, size_t end) {
+            (*static_cast<Body*>(context))(begin, end);
+        };
+        Run(job);
+    }
+
+private:
+    struct Job {
+        size_t count = 0;
+        size_t chunks = 0;
+        size_t participants = 0;
+        void* context = nullptr;
+        void (*run)(void* context, size_t begin, size_t end) = nullptr;
+        std::atomic<bool> cancelled{ false };
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        // Начало части chunk: части отличаются по размеру не больше чем на единицу
+        size_t ChunkBegin(size_t chunk) const noexcept {
+            return count / chunks * chunk + std::min(chunk, count % chunks);
+        }
+    };
+
+    // Группа частей участника. Владелец и забирающие потоки берут части одним fetch_add
+    struct alignas(64) Range {
+        std::atomic<size_t> next{ 0 };
+        size_t end = 0;
+    };
+
+    void Stop() noexcept {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void Run(Job& job) {
+        std::lock_guard run_lock(run_mutex_);
+        job.participants = std::min(Size(), job.chunks);
+        for (size_t i = 0; i < job.participants; ++i) {
+            ranges_[i].next.store(job.chunks * i / job.participants, std::memory_order_relaxed);
+            ranges_[i].end = job.chunks * (i + 1) / job.participants;
+        }
+        {
+            std::lock_guard lock(mutex_);
+            job_ = &job;
+            ++generation_;
+            active_ = job.participants - 1;
+        }
+        wake_.notify_all();
+        Work(job, 0);
+        {
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [this] {
+                return active_ == 0;
+            });
+            job_ = nullptr;
+        }
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    void WorkerLoop(size_t index) {
+        current_ = this;
+        size_t seen_generation = 0;
+        for (;;) {
+            Job* job = nullptr;
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [this, seen_generation] {
+                    return stop_ || generation_ != seen_generation;
+                });
+                if (stop_) {
+                    return;
+                }
+                seen_generation = generation_;
+                // Поток, не участвующий в задаче, может проснуться уже после её завершения
+                if (job_ == nullptr || index >= job_->participants) {
+                    continue;
+                }
+                job = job_;
+            }
+            Work(*job, index);
+            std::lock_guard lock(mutex_);
+            if (--active_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    // Обрабатывает свою группу частей, затем группы следующих участников по кругу
+    void Work(Job& job, size_t participant) noexcept {
+        ThreadPool* const outer = std::exchange(current_, this);
+        for (size_t i = 0; i < job.participants; ++i) {
+            Range& range = ranges_[(participant + i) % job.participants];
+            for (size_t chunk = range.next.fetch_add(1, std::memory_order_relaxed); chunk < range.end;
+                 chunk = range.next.fetch_add(1, std::memory_order_relaxed)) {
+                if (job.cancelled.load(std::memory_order_relaxed)) {
+                    current_ = outer;
+                    return;
+                }
+                try {
+                    job.run(job.context, job.ChunkBegin(chunk), job.ChunkBegin(chunk + 1));
+                }
+                catch (...) {
+                    std::lock_guard lock(job.error_mutex);
+                    if (!job.error) {
+                        job.error = std::current_exception();
+                    }
+                    job.cancelled.store(true, std::memory_order_relaxed);
+                }
+            }
+        }
+        current_ = outer;
+    }
+
+    static inline thread_local ThreadPool* current_ = nullptr;
+
+    std::unique_ptr<Range[]> ranges_;
+    Vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    Job* job_ = nullptr;
+    size_t generation_ = 0;
+    size_t active_ = 0;
+    bool stop_ = false;
+};
+
+// Политика параллельного выполнения на пуле pool (по умолчанию ThreadPool::Default()).
+// Части делаются не меньше MIN_CHUNK_BYTES, чтобы мелкие векторы обрабатывались одним потоком
+struct ParallelPolicy {
+    static constexpr size_t MIN_CHUNK_BYTES = size_t{ 1 } << 16;
+
+    ThreadPool* pool = nullptr;
+
+    ThreadPool& Pool() const {
+        return pool != nullptr ? *pool : ThreadPool::Default();
+    }
+
+    template <typename T>
+    static constexpr size_t Grain() noexcept {
+        return std::max<size_t>(1, MIN_CHUNK_BYTES / sizeof(T));
+    }
+
+    template <typename T, typename Body, typename Rollback>
+    void ForRanges(size_t count, Body body, Rollback rollback) const {
+        // Частей немного, поэтому успешные собираются под мьютексом
+        std::mutex done_mutex;
+        Vector<std::pair<size_t, size_t>> done;
+        done.Reserve(Pool().Size() * ThreadPool::CHUNKS_PER_THREAD);
+        try {
+            Pool().ParallelFor(count, Grain<T>(), [&](size_t begin, size_t end) {
+                body(begin, end);
+                std::lock_guard lock(done_mutex);
+                done.EmplaceBack(begin, end);
+            });
+        }
+        catch (...) {
+            for (const auto& [begin, end] : done) {
+                rollback(begin, end);
+            }
+            throw;
+        }
+    }
+};
+
+inline constexpr ParallelPolicy PAR{};
+
+template <>
+struct IsVectorExecutionPolicy<ParallelPolicy> : std::true_type {};
+
+// Вызывает f(element) для каждого элемента [first, last) из нескольких потоков
+template <typename T, typename F>
+void ParallelForEach(T* first, T* last, F f, const ParallelPolicy& policy = PAR) {
+    policy.Pool().ParallelFor(static_cast<size_t>(last - first), ParallelPolicy::Grain<T>(),
+                              [first, &f](size_t begin, size_t end) {
+                                  std::for_each(first + begin, first + end, f);
+                              });
+}
+
+// Записывает f(first[i]) в d_first[i]. Диапазоны не должны частично перекрываться
+template <typename T, typename U, typename F>
+U* ParallelTransform(const T* first, const T* last, U* d_first, F f, const ParallelPolicy& policy = PAR) {
+    const size_t count = static_cast<size_t>(last - first);
+    policy.Pool().ParallelFor(count, ParallelPolicy::Grain<T>(), [first, d_first, &f](size_t begin, size_t end) {
+        std::transform(first + begin, first + end, d_first + begin, f);
+    });
+    return d_first + count;
+}
+
+// Свёртка [first, last) с init операцией op, которая должна быть ассоциативной. Части
+// сворачиваются параллельно, результаты частей объединяются по порядку, поэтому op
+// не обязана быть коммутативной
+template <typename T, typename R, typename Op = std::plus<>>
+R ParallelReduce(const T* first, const T* last, R init, Op op = Op(), const ParallelPolicy& policy = PAR) {
+    const size_t count = static_cast<size_t>(last - first);
+    ThreadPool& pool = policy.Pool();
+    const size_t chunks = std::min((count + ParallelPolicy::Grain<T>() - 1) / ParallelPolicy::Grain<T>(),
+                                   pool.Size() * ThreadPool::CHUNKS_PER_THREAD);
+    if (chunks <= 1) {
+        return std::accumulate(first, last, std::move(init), op);
+    }
+    Vector<std::optional<R>> partial(chunks);
+    pool.ParallelFor(chunks, 1, [&](size_t chunk_begin, size_t chunk_end) {
+        for (size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+            const T* begin = first + count / chunks * chunk + std::min(chunk, count % chunks);
+            const T* end = first + count / chunks * (chunk + 1) + std::min(chunk + 1, count % chunks);
+            R value(*begin);
+            for (++begin; begin != end; ++begin) {
+                value = op(std::move(value), *begin);
+            }
+            partial[chunk].emplace(std::move(value));
+        }
+    });
+    for (std::optional<R>& value : partial) {
+        init = op(std::move(init), std::move(*value));
+    }
+    return init;
+}
+
+// Сортирует части параллельно через std::sort, затем попарно сливает их через std::inplace_merge,
+// на каждом шаге сливая пары одновременно. Сортировка не устойчива
+template <typename T, typename Compare = std::less<>>
+void ParallelSort(T* first, T* last, Compare comp = Compare(), const ParallelPolicy& policy = PAR) {
+    const size_t count = static_cast<size_t>(last - first);
+    ThreadPool& pool = policy.Pool();
+    const size_t chunks = std::min(count / ParallelPolicy::Grain<T>(), pool.Size());
+    if (chunks <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+    const auto chunk_begin = [first, count, chunks](size_t chunk) {
+        return first + count / chunks * chunk + std::min(chunk, count % chunks);
+    };
+    pool.ParallelFor(chunks, 1, [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            std::sort(chunk_begin(chunk), chunk_begin(chunk + 1), comp);
+        }
+    });
+    for (size_t width = 1; width < chunks; width *= 2) {
+        const size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        pool.ParallelFor(pairs, 1, [&](size_t begin, size_t end) {
+            for (size_t pair = begin; pair < end; ++pair) {
+                const size_t left = pair * 2 * width;
+                const size_t middle = std::min(left + width, chunks);
+                const size_t right = std::min(left + 2 * width, chunks);
+                std::inplace_merge(chunk_begin(left), chunk_begin(middle), chunk_begin(right), comp);
+            }
+        });
+    }
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation, typename F>
+void ParallelForEach(Vector<T, Alloc, Growth, Stats, Relocation>& vector, F f, const ParallelPolicy& policy = PAR) {
+    ParallelForEach(vector.begin(), vector.end(), std::move(f), policy);
+}
+
+// Возвращает вектор из f(element) для каждого элемента vector. Результат создаётся параллельно
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation, typename F>
+auto ParallelTransform(const Vector<T, Alloc, Growth, Stats, Relocation>& vector, F f, const ParallelPolicy& policy = PAR) {
+    using R = std::decay_t<std::invoke_result_t<F&, const T&>>;
+    const T* data = vector.begin();
+    return Vector<R>(
+        vector.Size(),
+        [data, &f](size_t i) {
+            return f(data[i]);
+        },
+        policy);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation, typename R, typename Op = std::plus<>>
+R ParallelReduce(const Vector<T, Alloc, Growth, Stats, Relocation>& vector, R init, Op op = Op(),
+                 const ParallelPolicy& policy = PAR) {
+    return ParallelReduce(vector.begin(), vector.end(), std::move(init), std::move(op), policy);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Relocation, typename Compare = std::less<>>
+void ParallelSort(Vector<T, Alloc, Growth, Stats, Relocation>& vector, Compare comp = Compare(),
+                  const ParallelPolicy& policy = PAR) {
+    ParallelSort(vector.begin(), vector.end(), std::move(comp), policy);
+}
@@ -0,0 +1,204 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Счётчики событий всех векторов, использующих политику VectorStats с одним тегом
+struct VectorStatsCounters {
+    std::atomic<uint64_t> allocations{ 0 };
+    std::atomic<uint64_t> deallocations{ 0 };
+    std::atomic<uint64_t> bytes_allocated{ 0 };
+    std::atomic<uint64_t> in_place_expansions{ 0 };
+    std::atomic<uint64_t> block_reallocations{ 0 };
+    std::atomic<uint64_t> reallocations{ 0 };
+    std::atomic<uint64_t> relocated_bitwise{ 0 };
+    std::atomic<uint64_t> relocated_by_move{ 0 };
+    std::atomic<uint64_t> relocated_by_copy{ 0 };
+    std::atomic<uint64_t> copied_bitwise{ 0 };
+    std::atomic<uint64_t> copied_by_element{ 0 };
+    std::atomic<uint64_t> zero_filled{ 0 };
+    std::atomic<uint64_t> value_initialized{ 0 };
+    std::atomic<uint64_t> shifted{ 0 };
+    std::atomic<uint64_t> peak_size{ 0 };
+    std::atomic<uint64_t> peak_capacity{ 0 };
+};
+
+// Снимок счётчиков для выгрузки в систему метрик
+struct VectorStatsSnapshot {
+    std::string_view name;
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t in_place_expansions = 0;
+    uint64_t block_reallocations = 0;
+    uint64_t reallocations = 0;
+    uint64_t relocated_bitwise = 0;
+    uint64_t relocated_by_move = 0;
+    uint64_t relocated_by_copy = 0;
+    uint64_t copied_bitwise = 0;
+    uint64_t copied_by_element = 0;
+    uint64_t zero_filled = 0;
+    uint64_t value_initialized = 0;
+    uint64_t shifted = 0;
+    uint64_t peak_size = 0;
+    uint64_t peak_capacity = 0;
+};
+
+// Счётчики одного тега вместе со звеном списка реестра
+struct VectorStatsNode {
+    explicit VectorStatsNode(std::string_view name) noexcept
+        : name(name) {
+    }
+
+    std::string_view name;
+    VectorStatsCounters counters;
+    VectorStatsNode* next = nullptr;
+};
+
+// Глобальный реестр счётчиков. Счётчики регистрируются при первом событии вектора с данным тегом.
+// Звенья хранятся в самих тегах и никогда не удаляются, поэтому регистрация не выделяет память
+// и не блокирует, а Snapshot и Reset обходят список без мьютекса
+class VectorStatsRegistry {
+public:
+    static VectorStatsRegistry& Instance() noexcept {
+        static VectorStatsRegistry registry;
+        return registry;
+    }
+
+    void Register(VectorStatsNode* node) noexcept {
+        VectorStatsNode* head = head_.load(std::memory_order_relaxed);
+        do {
+            node->next = head;
+        } while (!head_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Снимки в порядке регистрации
+    std::vector<VectorStatsSnapshot> Snapshot() const {
+        std::vector<VectorStatsSnapshot> result;
+        for (const VectorStatsNode* node = head_.load(std::memory_order_acquire); node != nullptr; node = node->next) {
+            const VectorStatsCounters& c = node->counters;
+            result.push_back({ node->name,
+                               c.allocations.load(std::memory_order_relaxed),
+                               c.deallocations.load(std::memory_order_relaxed),
+                               c.bytes_allocated.load(std::memory_order_relaxed),
+                               c.in_place_expansions.load(std::memory_order_relaxed),
+                               c.block_reallocations.load(std::memory_order_relaxed),
+                               c.reallocations.load(std::memory_order_relaxed),
+                               c.relocated_bitwise.load(std::memory_order_relaxed),
+                               c.relocated_by_move.load(std::memory_order_relaxed),
+                               c.relocated_by_copy.load(std::memory_order_relaxed),
+                               c.copied_bitwise.load(std::memory_order_relaxed),
+                               c.copied_by_element.load(std::memory_order_relaxed),
+                               c.zero_filled.load(std::memory_order_relaxed),
+                               c.value_initialized.load(std::memory_order_relaxed),
+                               c.shifted.load(std::memory_order_relaxed),
+                               c.peak_size.load(std::memory_order_relaxed),
+                               c.peak_capacity.load(std::memory_order_relaxed) });
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    // Обнуляет все зарегистрированные счётчики, например после выгрузки
+    void Reset() noexcept {
+        for (VectorStatsNode* node = head_.load(std::memory_order_acquire); node != nullptr; node = node->next) {
+            VectorStatsCounters& c = node->counters;
+            for (auto* counter : { &c.allocations, &c.deallocations, &c.bytes_allocated, &c.in_place_expansions,
+                                   &c.block_reallocations, &c.reallocations, &c.relocated_bitwise,
+                                   &c.relocated_by_move, &c.relocated_by_copy, &c.copied_bitwise,
+                                   &c.copied_by_element, &c.zero_filled, &c.value_initialized, &c.shifted,
+                                   &c.peak_size, &c.peak_capacity }) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    VectorStatsRegistry() = default;
+
+    std::atomic<VectorStatsNode*> head_{ nullptr };
+};
+
+// Политика статистики, накапливающая события в счётчиках, общих для всех векторов с тегом Tag.
+// Tag - любой тип со статическим членом NAME, обычно по одному тегу на место использования:
+//     struct RequestHeadersTag { static constexpr std::string_view NAME = "request_headers"; };
+//     Vector<Header, std::allocator<Header>, DoublingGrowth, VectorStats<RequestHeadersTag>> headers;
+template <typename Tag>
+struct VectorStats {
+    static void OnAllocate(size_t bytes) noexcept {
+        VectorStatsCounters& c = Counters();
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    static void OnDeallocate(size_t /*bytes*/) noexcept {
+        Counters().deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void OnResizeBlock(size_t old_bytes, size_t new_bytes, bool in_place) noexcept {
+        VectorStatsCounters& c = Counters();
+        (in_place ? c.in_place_expansions : c.block_reallocations).fetch_add(1, std::memory_order_relaxed);
+        if (new_bytes > old_bytes) {
+            c.bytes_allocated.fetch_add(new_bytes - old_bytes, std::memory_order_relaxed);
+        }
+    }
+
+    static void OnReallocation() noexcept {
+        Counters().reallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void OnRelocate(RelocationKind kind, size_t count) noexcept {
+        VectorStatsCounters& c = Counters();
+        switch (kind) {
+        case RelocationKind::BITWISE:
+            c.relocated_bitwise.fetch_add(count, std::memory_order_relaxed);
+            break;
+        case RelocationKind::MOVE:
+            c.relocated_by_move.fetch_add(count, std::memory_order_relaxed);
+            break;
+        case RelocationKind::COPY:
+            c.relocated_by_copy.fetch_add(count, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    static void OnCopy(bool bitwise, size_t count) noexcept {
+        VectorStatsCounters& c = Counters();
+        (bitwise ? c.copied_bitwise : c.copied_by_element).fetch_add(count, std::memory_order_relaxed);
+    }
+
+    static void OnValueInit(bool zero_fill, size_t count) noexcept {
+        VectorStatsCounters& c = Counters();
+        (zero_fill ? c.zero_filled : c.value_initialized).fetch_add(count, std::memory_order_relaxed);
+    }
+
+    static void OnShift(size_t count) noexcept {
+        Counters().shifted.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    static void OnSize(size_t size, size_t capacity) noexcept {
+        VectorStatsCounters& c = Counters();
+        UpdateMax(c.peak_size, size);
+        UpdateMax(c.peak_capacity, capacity);
+    }
+
+private:
+    static VectorStatsCounters& Counters() noexcept {
+        static VectorStatsNode* node = [] {
+            static VectorStatsNode instance{ Tag::NAME };
+            VectorStatsRegistry::Instance().Register(&instance);
+            return &instance;
+        }();
+        return node->counters;
+    }
+
+    static void UpdateMax(std::atomic<uint64_t>& max, uint64_t value) noexcept {
+        uint64_t current = max.load(std::memory_order_relaxed);
+        while (current < value && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+};